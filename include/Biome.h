@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Block/BlockTypes.h"
+
+#include <array>
+
+enum BiomeType
+{
+    Plains,
+    Hills,
+    Desert,
+    Mountains,
+    BiomeTypeCount
+};
+
+struct BiomeProperties
+{
+    const char *name;
+    float temperature;     // Climate this biome sits at, 0-1
+    float humidity;        // 0-1
+    float baseHeight;      // Surface height where the height noise is 0.5
+    float heightVariation; // Surface moves +-variation over the height noise's range
+    float stoneLevel;      // Filler blocks above this y, stone below
+    float caveThreshold;   // Cave density above this is carved, higher means fewer caves
+    float treeChance;      // Chance of a tree per surface column
+    float boulderChance;   // Chance of a boulder per surface column
+    BlockType surfaceBlock;
+    BlockType fillerBlock;
+};
+
+// Biome parameters indexed by BiomeType. Terrain parameters are blended between biomes by climate,
+// the blocks and feature chances come from the single closest biome
+namespace Biomes
+{
+    inline constexpr std::array<BiomeProperties, BiomeTypeCount> properties = {{
+        {"Plains", 0.55f, 0.6f, 120.0f, 40.0f, 100.0f, 0.62f, 0.004f, 0.0005f, BlockType::Grass, BlockType::Dirt},
+        {"Hills", 0.4f, 0.4f, 128.0f, 96.0f, 100.0f, 0.6f, 0.02f, 0.001f, BlockType::Grass, BlockType::Dirt},
+        {"Desert", 0.85f, 0.15f, 116.0f, 24.0f, 104.0f, 0.65f, 0.0f, 0.001f, BlockType::Sand, BlockType::Sand},
+        {"Mountains", 0.15f, 0.3f, 140.0f, 150.0f, 200.0f, 0.58f, 0.002f, 0.004f, BlockType::Stone, BlockType::Stone},
+    }};
+
+    constexpr const BiomeProperties &get(BiomeType type) { return properties[type]; }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Block/BlockTypes.h"
+
+#include <array>
+#include <cstdint>
+
+// Tile position in the texture atlas, in tiles from the top left
+struct AtlasTile
+{
+    uint8_t x;
+    uint8_t y;
+};
+
+struct BlockProperties
+{
+    const char *name;
+    bool visible;             // Has a mesh
+    bool solid;               // Can be targeted and collided with
+    bool opaque;              // Blocks light and hides the faces of neighboring blocks
+    uint8_t lightAttenuation; // Extra light lost when light passes through, opaque blocks stop it entirely
+    uint8_t emission;         // Light level given off, 0-15
+    std::array<AtlasTile, 6> faceTiles; // Indexed by BlockFaces
+};
+
+// Every block's properties in a flat table indexed by BlockType, built at compile time.
+// Adding a block is a new BlockType entry plus a row here.
+namespace BlockRegistry
+{
+    // Face order follows BlockFaces: Right, Left, Top, Bottom, Front, Back
+    constexpr std::array<AtlasTile, 6> faceTiles(AtlasTile top, AtlasTile side, AtlasTile bottom)
+    {
+        return {side, side, top, bottom, side, side};
+    }
+    constexpr std::array<AtlasTile, 6> allFaces(AtlasTile tile)
+    {
+        return faceTiles(tile, tile, tile);
+    }
+
+    inline constexpr std::array<BlockProperties, BlockTypeCount> properties = {{
+        {"Air", false, false, false, 0, 0, allFaces({0, 0})},
+        {"Grass", true, true, true, 15, 0, faceTiles({0, 0}, {3, 0}, {2, 0})},
+        {"Dirt", true, true, true, 15, 0, allFaces({2, 0})},
+        {"Stone", true, true, true, 15, 0, allFaces({1, 0})},
+        {"Cobblestone", true, true, true, 15, 0, allFaces({0, 1})},
+        {"Log", true, true, true, 15, 0, faceTiles({5, 1}, {4, 1}, {4, 1})},
+        {"Plank", true, true, true, 15, 0, allFaces({4, 0})},
+        {"Brick", true, true, true, 15, 0, allFaces({7, 0})},
+        {"Sand", true, true, true, 15, 0, allFaces({2, 1})},
+        {"Glass", true, true, false, 0, 0, allFaces({1, 3})},
+        {"Leaves", true, true, false, 1, 0, allFaces({4, 3})},
+        {"Torch", true, true, false, 0, 14, allFaces({0, 5})},
+    }};
+
+    constexpr const BlockProperties &get(BlockType type) { return properties[type]; }
+    constexpr bool isVisible(BlockType type) { return properties[type].visible; }
+    constexpr bool isSolid(BlockType type) { return properties[type].solid; }
+    constexpr bool isOpaque(BlockType type) { return properties[type].opaque; }
+    constexpr uint8_t getLightAttenuation(BlockType type) { return properties[type].lightAttenuation; }
+    constexpr uint8_t getEmission(BlockType type) { return properties[type].emission; }
+
+    static_assert(!isVisible(BlockType::Air) && !isOpaque(BlockType::Air), "Air must stay empty");
+}
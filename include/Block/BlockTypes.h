@@ -1,6 +1,7 @@
 #pragma once
 #include <glm/glm.hpp>
 
+// Block IDs, properties for each live in BlockRegistry
 enum BlockType
 {
     Air,
@@ -10,13 +11,11 @@ enum BlockType
     Cobblestone,
     Log,
     Plank,
-    Brick
+    Brick,
+    Sand,
+    Glass,
+    Leaves,
+    Torch,
 
+    BlockTypeCount // Keep last
 };
-
-struct BlockTextureAtlasIndicies
-{
-    glm::vec2 top;
-    glm::vec2 side;
-    glm::vec2 bottom;
-};
\ No newline at end of file
@@ -3,13 +3,16 @@
 #include "Chunk/ChunkCoord.h"
 #include "Chunk/ChunkStateMachine.h"
 #include "Chunk/ChunkMesh.h"
+#include "Chunk/ChunkSection.h"
 #include "Chunk/Vertex.h"
-#include "Block/Block.h"
+#include "Block/BlockTypes.h"
+#include "Block/BlockRegistry.h"
 #include "Constants.h"
-#include "TerrainGenerator.h"
 
 #include <vector>
+#include <array>
 #include <memory>
+#include <cstdint>
 
 #include <glm/glm.hpp>
 
@@ -17,7 +20,8 @@ class ChunkManager;
 class ChunkPipeline;
 class MeshData;
 class Shader;
-class TextureAtlas;
+class TerrainGenerator;
+struct TerrainColumn;
 
 struct BoundingBox
 {
@@ -29,27 +33,101 @@ class Chunk : public std::enable_shared_from_this<Chunk>
 {
 
 public:
-    Chunk(Shader &shader, TextureAtlas &atlas, ChunkCoord pos);
+    // Without a shader the chunk can't be given meshes, headless tools pass null
+    Chunk(Shader *shader, ChunkCoord pos);
+    // Reuse this chunk's storage for a different position, see ChunkPool
+    void reset(ChunkCoord pos);
 
     // Operate on own block data
-    void generateTerrain();
+    void generateTerrain(const TerrainGenerator &generator);
     void removeBlockAt(glm::ivec3 pos);
     void setBlockAt(glm::ivec3 pos, BlockType type);
 
     // Getters/Setters
-    std::vector<Block> &getBlocks();
-    ChunkMesh &getMesh();
-    void setMeshData(MeshData &newMeshData);
+    // Null until the section first has something to draw
+    inline ChunkMesh *getSectionMesh(int index) const { return sectionMeshes_[index].get(); }
+    void setSectionMeshData(int index, MeshData &&newMeshData);
+    BoundingBox getSectionBoundingBox(int index) const;
     const ChunkCoord getCoord() const;
     const BoundingBox getBoundingBox() const;
-    const TextureAtlas &getTextureAtlasRef() const;
-    Block *getBlockLocal(const glm::ivec3 &pos);
+
+    // Block data, pos must be in chunk bounds
+    inline BlockType getBlockType(const glm::ivec3 &pos) const { return getSectionAt(pos.y).getBlock(getSectionBlockIndex(pos)); }
+    inline uint8_t getSkylight(const glm::ivec3 &pos) const { return getSectionAt(pos.y).getSkylight(getSectionBlockIndex(pos)); }
+    inline void setSkylight(const glm::ivec3 &pos, uint8_t level)
+    {
+        getSectionAt(pos.y).setSkylight(getSectionBlockIndex(pos), level);
+        markBlockDirty(pos);
+    }
+    void clearSkylight();
+    inline uint8_t getBlocklight(const glm::ivec3 &pos) const { return getSectionAt(pos.y).getBlocklight(getSectionBlockIndex(pos)); }
+    inline void setBlocklight(const glm::ivec3 &pos, uint8_t level)
+    {
+        getSectionAt(pos.y).setBlocklight(getSectionBlockIndex(pos), level);
+        markBlockDirty(pos);
+    }
+    void clearBlocklight();
+    inline uint8_t getLight(LightChannel channel, const glm::ivec3 &pos) const
+    {
+        return getSectionAt(pos.y).getLight(channel, getSectionBlockIndex(pos));
+    }
+    inline void setLight(LightChannel channel, const glm::ivec3 &pos, uint8_t level)
+    {
+        getSectionAt(pos.y).setLight(channel, getSectionBlockIndex(pos), level);
+        markBlockDirty(pos);
+    }
+    size_t getMemoryUsage() const;
+
+    inline ChunkSection &getSection(int index) { return sections_[index]; }
+    inline const ChunkSection &getSection(int index) const { return sections_[index]; }
+    // True if the section is a single opaque block type
+    bool isSectionUniformSolid(int index) const;
+
+    // Sections deep below the surface start out as opaque placeholder stone and only get their
+    // real blocks, caves included, once something needs to look inside
+    inline bool isSectionGenerated(int index) const { return !((ungeneratedSections_ >> index) & 1); }
+    inline uint16_t getUngeneratedSections() const { return ungeneratedSections_; }
+    // Generates a placeholder section's real blocks, false if it already had them. Light is left to the caller
+    bool materializeSection(int index, const TerrainGenerator &generator);
+    // A placeholder section with sky light on the bottom layer of the section above, meaning a cave
+    // from the surface runs into it. -1 if there's none
+    int findLitPlaceholderSection() const;
+
+    // Opacity bitmask, one 16 bit row along x per (y, z)
+    inline bool isOpaque(const glm::ivec3 &pos) const { return (opaqueRows_[getRowIndex(pos.y, pos.z)] >> pos.x) & 1; }
+    inline uint16_t getOpaqueRow(int y, int z) const { return opaqueRows_[getRowIndex(y, z)]; }
+    static inline bool isOpaqueBlock(BlockType type) { return BlockRegistry::isOpaque(type); }
+
+    // Heightmap, y of the highest non-air block in a column or -1 if the column is empty.
+    // Transparent blocks count so everything above it is guaranteed to be open air
+    inline int getHeight(int x, int z) const { return heightMap_[x + z * Constants::CHUNK_SIZE_X]; }
+    inline int getMaxHeight() const { return maxHeight_; }
+    inline int getMinHeight() const { return minHeight_; }
+
+    // Sections whose mesh is out of date, one bit per section
+    inline uint16_t getDirtySections() const { return dirtySections_; }
+    inline void clearSectionDirty(int index) { dirtySections_ &= ~(1 << index); }
+    inline void markAllSectionsDirty() { dirtySections_ = 0xFFFF; }
+    inline void markSectionDirty(int index) { dirtySections_ |= static_cast<uint16_t>(1 << index); }
+    // A block's faces, AO and light are sampled from its neighbors, so blocks on a section's
+    // top or bottom layer dirty the section next to it too
+    inline void markBlockDirty(const glm::ivec3 &pos)
+    {
+        const int localY = pos.y % Constants::SECTION_SIZE;
+        uint32_t mask = 1u << (pos.y / Constants::SECTION_SIZE);
+        if (localY == 0)
+            mask |= mask >> 1;
+        else if (localY == Constants::SECTION_SIZE - 1)
+            mask |= mask << 1;
+        dirtySections_ |= static_cast<uint16_t>(mask);
+    }
 
     // State
     ChunkState getState() const;
     void setState(ChunkState newState);
 
-    static inline size_t getBlockIndex(const glm::ivec3 &pos) { return pos.x + (pos.y * Constants::CHUNK_SIZE_X) + (pos.z * Constants::CHUNK_SIZE_X * Constants::CHUNK_SIZE_Y); }
+    // Index of a chunk local position inside the section that holds it
+    static inline int getSectionBlockIndex(const glm::ivec3 &pos) { return ChunkSection::getBlockIndex({pos.x, pos.y % Constants::SECTION_SIZE, pos.z}); }
     static inline bool blockPosInChunkBounds(const glm::ivec3 &pos)
     {
         return pos.x >= 0 && pos.x < Constants::CHUNK_SIZE_X &&
@@ -59,11 +137,34 @@ public:
 
 private:
     // ---- Core Data ------
-    std::vector<Block> blocks_;
-    ChunkMesh mesh_;
+    std::array<ChunkSection, Constants::SECTIONS_PER_CHUNK> sections_; // Bottom to top, 16 blocks tall each
+    std::array<uint16_t, Constants::CHUNK_SIZE_Y * Constants::CHUNK_SIZE_Z> opaqueRows_;
+    std::array<int16_t, Constants::CHUNK_SIZE_X * Constants::CHUNK_SIZE_Z> heightMap_;
+    int maxHeight_ = -1;
+    int minHeight_ = -1;
+    std::array<std::unique_ptr<ChunkMesh>, Constants::SECTIONS_PER_CHUNK> sectionMeshes_;
+    uint16_t dirtySections_ = 0xFFFF;
+    uint16_t ungeneratedSections_ = 0;
     ChunkStateMachine stateMachine_;
     ChunkCoord chunkCoord_;
     BoundingBox boundingBox_;
-    TerrainGenerator terrainGen_;
-    TextureAtlas &textureAtlas_;
+    Shader *chunkShader_;
+
+    void setCoord(ChunkCoord pos);
+    // Surface and biome of every column, heights clamped to the chunk
+    void getTerrainColumns(const TerrainGenerator &generator, TerrainColumn *columns) const;
+    // Fills minY to maxY of every column, clipped to its surface. Rows must start out empty
+    void fillColumns(const TerrainGenerator &generator, const TerrainColumn *columns, int minY, int maxY);
+    void updateOpacity(const glm::ivec3 &pos, BlockType type);
+    void updateHeightMap(const glm::ivec3 &pos, BlockType type);
+    void updateHeightBounds();
+
+    static inline int getRowIndex(int y, int z) { return y * Constants::CHUNK_SIZE_Z + z; }
+    static constexpr uint16_t FULL_ROW = static_cast<uint16_t>((1u << Constants::CHUNK_SIZE_X) - 1);
+    static constexpr BlockType PLACEHOLDER_BLOCK = BlockType::Stone;
+    static_assert(Constants::CHUNK_SIZE_X <= 16, "Opacity rows are 16 bits wide");
+    static_assert(Constants::SECTIONS_PER_CHUNK == 16, "Dirty section mask is 16 bits wide");
+
+    inline ChunkSection &getSectionAt(int y) { return sections_[y / Constants::SECTION_SIZE]; }
+    inline const ChunkSection &getSectionAt(int y) const { return sections_[y / Constants::SECTION_SIZE]; }
 };
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Constants.h"
+
+#include <glm/glm.hpp>
+
+// Compile time policies mapping a position inside a 16x16x16 section to an index into its block arrays.
+// Named from the fastest to the slowest changing axis. Pick one with -DCHUNK_BLOCK_LAYOUT=<name> in CMake.
+namespace ChunkLayout
+{
+    constexpr int SIZE = Constants::SECTION_SIZE;
+    static_assert(SIZE == 16, "Chunk layouts assume 16 block wide sections");
+
+    // Rows along x, then y, then z
+    struct XYZ
+    {
+        static constexpr const char *name = "XYZ";
+        static constexpr int index(int x, int y, int z) { return x + y * SIZE + z * SIZE * SIZE; }
+        static inline glm::ivec3 position(int index) { return glm::ivec3(index & 15, (index >> 4) & 15, index >> 8); }
+    };
+
+    // Horizontal 16x16 layers stacked bottom to top
+    struct XZY
+    {
+        static constexpr const char *name = "XZY";
+        static constexpr int index(int x, int y, int z) { return x + z * SIZE + y * SIZE * SIZE; }
+        static inline glm::ivec3 position(int index) { return glm::ivec3(index & 15, index >> 8, (index >> 4) & 15); }
+    };
+
+    // Vertical columns, walking up or down a column is sequential
+    struct YZX
+    {
+        static constexpr const char *name = "YZX";
+        static constexpr int index(int x, int y, int z) { return y + z * SIZE + x * SIZE * SIZE; }
+        static inline glm::ivec3 position(int index) { return glm::ivec3(index >> 8, index & 15, (index >> 4) & 15); }
+    };
+
+    // Z-order curve, neighbors in every direction tend to share a cache line
+    struct Morton
+    {
+        static constexpr const char *name = "Morton";
+        static constexpr int index(int x, int y, int z) { return spread(x) | (spread(y) << 1) | (spread(z) << 2); }
+        static inline glm::ivec3 position(int index) { return glm::ivec3(compact(index), compact(index >> 1), compact(index >> 2)); }
+
+    private:
+        // Moves bits 0-3 of v to bits 0, 3, 6, 9
+        static constexpr int spread(int v)
+        {
+            v &= 0xF;
+            v = (v | (v << 4)) & 0x0C3;
+            v = (v | (v << 2)) & 0x249;
+            return v;
+        }
+        // Inverse of spread
+        static constexpr int compact(int v)
+        {
+            v &= 0x249;
+            v = (v | (v >> 2)) & 0x0C3;
+            v = (v | (v >> 4)) & 0xF;
+            return v;
+        }
+    };
+}
+
+#if defined(CHUNK_LAYOUT_XYZ)
+using ChunkBlockLayout = ChunkLayout::XYZ;
+#elif defined(CHUNK_LAYOUT_XZY)
+using ChunkBlockLayout = ChunkLayout::XZY;
+#elif defined(CHUNK_LAYOUT_MORTON)
+using ChunkBlockLayout = ChunkLayout::Morton;
+#else
+using ChunkBlockLayout = ChunkLayout::YZX;
+#endif
@@ -2,7 +2,7 @@
 
 #include "Chunk/Chunk.h"
 #include "Chunk/ChunkCoord.h"
-#include "Block/Block.h"
+#include "Chunk/ChunkPool.h"
 #include "Shader.h"
 #include "TextureAtlas.h"
 #include "Camera.h"
@@ -39,7 +39,7 @@ public:
     template <typename Visitor>
     void forEachChunk(Visitor &&v)
     {
-        for (const auto [coord, chunk] : chunks_)
+        for (const auto &[coord, chunk] : chunks_)
         {
             if (!chunk)
                 continue;
@@ -48,6 +48,7 @@ public:
     }
 
     const TextureAtlas &getTextureAtlasRef() const;
+    ChunkPool &getChunkPool();
     const std::shared_ptr<Chunk> getChunk(const ChunkCoord &coord) const;
     std::array<std::shared_ptr<Chunk>, 4> getChunkNeighbors(const ChunkCoord &coord);
 
@@ -66,6 +67,7 @@ private:
     Camera &camera_;
     Shader chunkShader_;
     TextureAtlas textureAtlas_;
+    ChunkPool chunkPool_;
     ChunkPipeline *pipeline_;
 
     void processStateChanges();
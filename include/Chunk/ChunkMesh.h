@@ -24,7 +24,16 @@ public:
     ChunkMesh(Shader &chunkShader);
     void render(const ChunkCoord &coord);
     void uploadMesh();
+    // Built but not uploaded yet
+    inline bool hasPendingUpload() const { return !meshData_.indices_.empty(); }
+    // Something is on the GPU to draw
+    inline bool isDrawable() const { return hasValidMesh_ && indicesCount_ > 0; }
+    // Hands the CPU side buffers back once they're on the GPU
+    MeshData takeMeshData();
     void setMeshValid();
+    // Drops the current mesh but keeps buffers and GL objects for reuse
+    void reset();
+    size_t getMemoryUsage() const;
 
 private:
     VertexArray vao_;
@@ -1,23 +1,33 @@
 #pragma once
 
 #include "Block/BlockFaceData.h"
+#include "Block/BlockTypes.h"
 
 #include <vector>
 #include <memory>
 #include <functional>
 #include <array>
 
-class Block;
 class Chunk;
 class MeshData;
 class TextureAtlas;
 
-// Responsible for generating a mesh (vertices and indices) for a chunk
+// Type, opacity and light of a neighboring block, missing neighbors read as unlit air
+struct NeighborBlock
+{
+    BlockType type = BlockType::Air;
+    bool opaque = false;
+    uint8_t skylight = 0;
+    uint8_t blocklight = 0;
+};
+
+// Responsible for generating the mesh (vertices and indices) of a chunk section
 class ChunkMeshBuilder
 {
 public:
     ChunkMeshBuilder(MeshData &meshData, const TextureAtlas &atlas, std::shared_ptr<Chunk> chunk, const std::array<std::shared_ptr<Chunk>, 4> &neighborChunks);
-    MeshData &buildMesh();
+    // Appends the faces of one 16 tall section, positions stay chunk local
+    MeshData &buildSectionMesh(int sectionIndex);
 
 private:
     MeshData &meshData_;
@@ -25,10 +35,14 @@ private:
     const std::array<std::shared_ptr<Chunk>, 4> &neighborChunks_;
     const TextureAtlas &textureAtlas_;
 
-    void generateBlockMesh(Block &block);
-    void generateFaceMesh(Block &block, uint8_t adjacentBlockSkylight, BlockFaces face, const std::function<Block *(int, int, int)> &getNeighborPtrFromCache);
+    using NeighborCache = std::array<NeighborBlock, 27>;
+
+    void generateBlockMesh(const glm::ivec3 &pos, BlockType type);
+    void generateFaceMesh(const glm::ivec3 &pos, BlockType type, const NeighborBlock &adjacentBlock, BlockFaces face, const NeighborCache &cache);
 
-    Block *getNeighborBlock(const glm::ivec3 blockPos, const glm::ivec3 offset);
+    NeighborBlock getNeighborBlock(const glm::ivec3 blockPos, const glm::ivec3 offset);
+    // Convert offset from [-1, 1] to [0, 2] for cache indexing
+    static inline int getCacheIndex(int x, int y, int z) { return (x + 1) + (y + 1) * 3 + (z + 1) * 9; }
     bool isBlockHiddenByNeighbors(const glm::ivec3 &pos);
-    inline bool isTransparent(BlockType type) const;
+    bool isSectionHidden(int sectionIndex) const;
 };
\ No newline at end of file
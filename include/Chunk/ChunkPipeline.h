@@ -1,25 +1,71 @@
 #pragma once
 
+#include "Chunk/ChunkManager.h"
+#include "Chunk/PendingBlockWrites.h"
+#include "LightSystem.h"
+#include "ThreadPool.h"
+
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
 
 class Chunk;
 class ChunkManager;
-class LightSystem;
+class FeatureGenerator;
+class TerrainGenerator;
 
 // Responsible for handling the whole chunk pipeline process
-// Generate terrain -> Propogate light -> Mesh -> Upload to GPU -> Handle remeshing
+// Generate terrain and features -> Propogate light -> Mesh -> Upload to GPU -> Handle remeshing
+// Terrain and initial light only touch their own chunk so they run on worker threads,
+// the stages that read neighbors or touch OpenGL stay on the main thread
 class ChunkPipeline
 {
 public:
     ChunkPipeline();
-    void init(ChunkManager *chunkManager, LightSystem *lightSystem);
+    void init(ChunkManager *chunkManager, LightSystem *lightSystem, const TerrainGenerator *terrainGenerator,
+              const FeatureGenerator *featureGenerator);
     void generateTerrain(std::shared_ptr<Chunk> chunk);
     void seedInitialLight(std::shared_ptr<Chunk> chunk);
     void propogateLight(std::shared_ptr<Chunk> chunk);
     void generateMesh(std::shared_ptr<Chunk> chunk);
     void uploadMeshToGPU(std::shared_ptr<Chunk> chunk);
+    // Main thread only, hands events from finished worker tasks to the chunk manager
+    void processCompletedTasks();
+    // Main thread only, applies feature blocks that arrived after their target chunk was generated
+    void applyLateFeatureWrites();
+    // Main thread only, gives a loaded chunk's placeholder section its real blocks and relights the chunk
+    void materializeSection(std::shared_ptr<Chunk> chunk, int sectionIndex);
+    // Main thread only, after a block in a loaded chunk was placed or removed. Fixes the light
+    // around it and remeshes every chunk whose faces changed
+    void onBlockChanged(std::shared_ptr<Chunk> chunk, const glm::ivec3 &localPos);
+    // Main thread only, lights a loaded chunk and the chunks around it from scratch.
+    // FINAL_LIGHT_READY sends the chunk back through meshing, its neighbors get remeshed
+    void relight(std::shared_ptr<Chunk> chunk);
+    void onChunkRemoved(const ChunkCoord &coord);
 
 private:
     ChunkManager *chunkManager_;
     LightSystem *lightSystem_;
+    const TerrainGenerator *terrainGenerator_;
+    const FeatureGenerator *featureGenerator_;
+
+    // Feature blocks that spilled into other chunks, and the chunks still waiting to be loaded to take them
+    PendingBlockWrites pendingWrites_;
+    std::unordered_set<ChunkCoord> lateWriteTargets_;
+
+    // Filled by workers, drained on the main thread
+    std::vector<StateChangeEvent> completedTasks_;
+    std::mutex completedMutex_;
+    std::atomic<int> tasksInFlight_{0};
+
+    // Last member so workers are joined before anything they use is destroyed
+    ThreadPool workerPool_;
+
+    void completeTask(StateChangeEvent event);
+    // Initial sky and block light, generating any placeholder sections that sky light runs into through a cave
+    void seedLight(std::shared_ptr<Chunk> chunk);
+    // The 3x3 chunks around coord that light can be read and written in
+    LightSystem::Neighborhood getLightWindow(const ChunkCoord &coord) const;
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Chunk/ChunkCoord.h"
+#include "Chunk/MeshData.h"
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+class Chunk;
+class Shader;
+
+// Keeps unloaded chunks and mesh scratch buffers around so their block storage,
+// mesh capacity and GL objects get reused instead of reallocated
+class ChunkPool
+{
+public:
+    ChunkPool(Shader *chunkShader, size_t maxChunks, size_t maxMeshData);
+
+    std::shared_ptr<Chunk> acquire(const ChunkCoord &coord);
+    // Only recycles the chunk if nothing else still holds it
+    void release(std::shared_ptr<Chunk> chunk);
+
+    // Scratch buffers for mesh building, they keep their capacity between meshes
+    MeshData acquireMeshData();
+    void releaseMeshData(MeshData &&meshData);
+
+    size_t getRetainedBytes() const { return retainedBytes_; }
+    // Hit rate and retained memory to the profiler, once per frame
+    void reportStats() const;
+
+private:
+    Shader *chunkShader_;
+    const size_t maxChunks_;
+    const size_t maxMeshData_;
+
+    std::vector<std::shared_ptr<Chunk>> freeChunks_;
+    std::vector<MeshData> freeMeshData_;
+
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    // Kept up to date by acquire and release so reporting doesn't walk the pool
+    size_t retainedBytes_ = 0;
+
+    static size_t getCapacityBytes(const MeshData &meshData);
+};
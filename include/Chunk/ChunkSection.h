@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Chunk/NibbleArray.h"
+#include "Chunk/ChunkLayout.h"
+#include "Block/BlockTypes.h"
+#include "Constants.h"
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// Sky light comes down from above the world, block light from emissive blocks.
+// Each is 4 bits per block and only allocated for sections where it isn't uniform
+enum class LightChannel
+{
+    Sky,
+    Block
+};
+
+// A 16x16x16 slice of a chunk's blocks.
+// Blocks are stored as indices into a local palette of block types, bit-packed
+// into 64 bit words. The index width grows (1, 2, 4, 8, 16 bits) as the palette does.
+// A section made of a single block type keeps only its palette (0 bits per entry).
+class ChunkSection
+{
+public:
+    static constexpr int SIZE = Constants::SECTION_SIZE;
+    static constexpr int VOLUME = SIZE * SIZE * SIZE;
+
+    ChunkSection();
+
+    inline BlockType getBlock(int index) const
+    {
+        if (bitsPerEntry_ == 0)
+            return static_cast<BlockType>(palette_[0]);
+
+        const int bitIndex = index * bitsPerEntry_;
+        const uint64_t word = data_[bitIndex >> 6];
+        const uint64_t mask = (uint64_t(1) << bitsPerEntry_) - 1;
+        return static_cast<BlockType>(palette_[(word >> (bitIndex & 63)) & mask]);
+    }
+    void setBlock(int index, BlockType type);
+    // Fill, reset and compact keep the packed indices' capacity, so a pooled chunk's next terrain reuses it
+    void fill(BlockType type);
+    // Back to an unlit air section
+    void reset();
+    // Drops unused palette entries and narrows the packed indices, collapsing to a uniform section when possible
+    void compact();
+
+    inline bool isUniform() const { return bitsPerEntry_ == 0; }
+    // Only meaningful for uniform sections
+    inline BlockType getUniformBlock() const { return static_cast<BlockType>(palette_[0]); }
+
+    inline uint8_t getSkylight(int index) const { return skylight_.get(index); }
+    inline void setSkylight(int index, uint8_t level) { skylight_.set(index, level); }
+    void fillSkylight(uint8_t level);
+
+    inline uint8_t getBlocklight(int index) const { return blocklight_.get(index); }
+    inline void setBlocklight(int index, uint8_t level) { blocklight_.set(index, level); }
+    void fillBlocklight(uint8_t level);
+
+    inline uint8_t getLight(LightChannel channel, int index) const
+    {
+        return channel == LightChannel::Sky ? skylight_.get(index) : blocklight_.get(index);
+    }
+    inline void setLight(LightChannel channel, int index, uint8_t level)
+    {
+        (channel == LightChannel::Sky ? skylight_ : blocklight_).set(index, level);
+    }
+
+    // True if any block type in the palette gives off light
+    bool hasEmitters() const;
+    // True if any see-through block type in the palette dims light passing through it
+    bool hasAttenuators() const;
+
+    size_t getPaletteSize() const;
+    size_t getMemoryUsage() const;
+
+    // Position inside a section <-> index into the packed arrays, order is set by ChunkBlockLayout
+    static inline int getBlockIndex(const glm::ivec3 &localPos) { return ChunkBlockLayout::index(localPos.x, localPos.y, localPos.z); }
+    static inline glm::ivec3 getBlockPosition(int index) { return ChunkBlockLayout::position(index); }
+
+private:
+    std::vector<uint16_t> palette_; // Local palette index -> BlockType
+    std::vector<uint64_t> data_;    // Packed palette indices, entries never straddle two words
+    int bitsPerEntry_;
+    NibbleArray skylight_;
+    NibbleArray blocklight_;
+
+    int getOrAddPaletteIndex(BlockType type);
+    void resize(int newBitsPerEntry);
+    inline void setPaletteIndex(int index, uint32_t paletteIndex)
+    {
+        const int bitIndex = index * bitsPerEntry_;
+        const int shift = bitIndex & 63;
+        const uint64_t mask = (uint64_t(1) << bitsPerEntry_) - 1;
+        uint64_t &word = data_[bitIndex >> 6];
+        word = (word & ~(mask << shift)) | (uint64_t(paletteIndex) << shift);
+    }
+};
@@ -23,6 +23,8 @@ private:
 
 public:
     void setState(ChunkState state);
+    // Back to EMPTY, bypassing transition checks
+    void reset();
     ChunkState getState() const;
     bool canTransitionTo(ChunkState newState) const;
     static const char *toString(ChunkState state);
@@ -4,8 +4,15 @@
 
 #include <vector>
 
+// Move-only so a finished mesh is handed off without copying its buffers
 struct MeshData
 {
     std::vector<Vertex> vertices_;
     std::vector<unsigned int> indices_;
+
+    MeshData() = default;
+    MeshData(MeshData &&) = default;
+    MeshData &operator=(MeshData &&) = default;
+    MeshData(const MeshData &) = delete;
+    MeshData &operator=(const MeshData &) = delete;
 };
\ No newline at end of file
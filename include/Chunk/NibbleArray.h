@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// Fixed size array of 4 bit values, two per byte.
+// While every value is the same only that value is kept and nothing is allocated.
+class NibbleArray
+{
+public:
+    explicit NibbleArray(size_t size, uint8_t value = 0) : size_(size), uniformValue_(value & 0xF) {}
+
+    inline uint8_t get(size_t index) const
+    {
+        if (data_.empty())
+            return uniformValue_;
+        return (data_[index >> 1] >> ((index & 1) * 4)) & 0xF;
+    }
+
+    inline void set(size_t index, uint8_t value)
+    {
+        if (data_.empty())
+        {
+            if ((value & 0xF) == uniformValue_)
+                return;
+            data_.assign((size_ + 1) / 2, static_cast<uint8_t>(uniformValue_ | (uniformValue_ << 4)));
+        }
+
+        const int shift = (index & 1) * 4;
+        data_[index >> 1] = (data_[index >> 1] & ~(0xF << shift)) | ((value & 0xF) << shift);
+    }
+
+    // Drops the per value storage
+    void fill(uint8_t value)
+    {
+        uniformValue_ = value & 0xF;
+        std::vector<uint8_t>().swap(data_);
+    }
+
+    // Same as fill, but keeps the allocation around for reuse
+    void reset(uint8_t value)
+    {
+        uniformValue_ = value & 0xF;
+        data_.clear();
+    }
+
+    bool isUniform() const { return data_.empty(); }
+    size_t getMemoryUsage() const { return data_.capacity(); }
+
+private:
+    std::vector<uint8_t> data_;
+    size_t size_;
+    uint8_t uniformValue_;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Chunk/ChunkCoord.h"
+#include "FeatureGenerator.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class Chunk;
+
+// Feature blocks that spilled out of the chunk that grew them, stored per target chunk in its local
+// coordinates until the target is there to take them. Each source chunk's blocks are kept separately
+// so a regenerated source replaces its old blocks instead of piling up duplicates.
+// Sharded by target so workers writing to different chunks never wait on each other
+class PendingBlockWrites
+{
+public:
+    // Replaces whatever source stored for target before
+    void setWrites(const ChunkCoord &source, const ChunkCoord &target, std::vector<FeatureBlock> blocks);
+    // Every block stored for target by any source. Applying is idempotent so they're kept
+    // around for when the target gets unloaded and generated again
+    std::vector<FeatureBlock> getWrites(const ChunkCoord &target);
+    // Applies everything stored for the chunk, true if any block changed
+    bool applyTo(Chunk &chunk);
+    // The source was unloaded, drops what it stored for the chunks around it
+    void removeSource(const ChunkCoord &source);
+    // Targets that got new blocks since the last call
+    std::vector<ChunkCoord> takeWrittenTargets();
+
+    inline size_t getBlockCount() const { return blockCount_.load(); }
+
+private:
+    struct SourceWrites
+    {
+        ChunkCoord source;
+        std::vector<FeatureBlock> blocks;
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<ChunkCoord, std::vector<SourceWrites>> targets;
+    };
+
+    static constexpr size_t SHARD_COUNT = 16;
+    std::array<Shard, SHARD_COUNT> shards_;
+
+    std::vector<ChunkCoord> writtenTargets_;
+    std::mutex writtenMutex_;
+    std::atomic<size_t> blockCount_{0};
+
+    inline Shard &getShard(const ChunkCoord &coord) { return shards_[std::hash<ChunkCoord>{}(coord) % SHARD_COUNT]; }
+};
@@ -6,5 +6,6 @@ struct Vertex
     glm::vec3 position;
     glm::vec2 textureCoords;
     float ao;
+    // Sky light + block light * 16, both 0-15. Whole numbers are exact in a float, the shader splits them
     float light;
 };
\ No newline at end of file
@@ -18,16 +18,31 @@ namespace Constants
     constexpr int CHUNK_SIZE_X = 16;
     constexpr int CHUNK_SIZE_Y = 256;
     constexpr int CHUNK_SIZE_Z = 16;
+    constexpr int SECTION_SIZE = 16;
+    constexpr int SECTIONS_PER_CHUNK = CHUNK_SIZE_Y / SECTION_SIZE;
 
     // terrain generation settings
-    constexpr int TERRAIN_BASE_HEIGHT = 128;
-    constexpr int TERRAIN_HEIGHT_VARIATION = 96;
-    constexpr int STONE_LEVEL = 100;
-    constexpr float CAVE_THRESHOLD = 0.6f;
+    constexpr int WORLD_SEED = 1337;
     constexpr float CAVE_START_Y = 50;
+    // Climate is sampled every BIOME_GRID_SIZE blocks and interpolated in between,
+    // BIOME_BLEND_SHARPNESS sets how quickly one biome gives way to the next
+    constexpr int BIOME_GRID_SIZE = 16;
+    constexpr float BIOME_CLIMATE_FREQUENCY = 0.0015f;
+    constexpr float BIOME_BLEND_SHARPNESS = 2.0f;
+    // Noise tiles shared by neighboring chunks, TILE_SIZE blocks square, CACHE_SIZE tiles kept
+    constexpr int NOISE_TILE_SIZE = 64;
+    constexpr int NOISE_TILE_CACHE_SIZE = 64;
+    // Cave density lattice spacing, finer is more detailed caves but more noise samples per chunk
+    constexpr int CAVE_LATTICE_XZ = 4;
+    constexpr int CAVE_LATTICE_Y = 8;
+    // Blocks below the lowest surface in a chunk that are generated straight away, deeper
+    // sections wait until they're needed
+    constexpr int LAZY_SECTION_MARGIN = 16;
 
     // rendering settings
     constexpr int RENDER_DISTANCE = 5;
+    constexpr int CHUNK_POOL_SIZE = 64;      // Unloaded chunks kept for reuse
+    constexpr int MESH_SCRATCH_POOL_SIZE = 8; // Mesh building buffers kept for reuse
 
     // Raycast
     constexpr int MAX_RAYCAST_DIST = 10;
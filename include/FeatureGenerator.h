@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Constants.h"
+#include "Block/BlockTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Chunk;
+class PendingBlockWrites;
+class TerrainGenerator;
+
+// A block placed by a feature. Relative to the chunk it's stored for, x and z fall outside
+// the chunk when a feature spills over a border
+struct FeatureBlock
+{
+    glm::ivec3 pos;
+    BlockType type;
+};
+
+// Decorates generated terrain with trees and boulders. Where features go only depends on the seed
+// and the origin chunk's own terrain, so every chunk grows the same features whatever order they load in.
+// Immutable after construction and shared by every worker like TerrainGenerator
+class FeatureGenerator
+{
+public:
+    FeatureGenerator(const TerrainGenerator &terrainGenerator, int seed = Constants::WORLD_SEED);
+
+    // Every block of the features rooted in this chunk, its terrain must already be generated
+    void generateFeatures(const Chunk &chunk, std::vector<FeatureBlock> &out) const;
+    // Generates the chunk's features, writing the blocks inside it and storing the ones that spill
+    // over its borders for the neighbors they land in
+    void placeFeatures(Chunk &chunk, PendingBlockWrites &pendingWrites) const;
+
+    // Features only fill air or replace a lower priority feature block, so applying the same blocks
+    // in any order, or more than once, gives the same result. True if the block changed
+    static bool applyBlock(Chunk &chunk, const glm::ivec3 &pos, BlockType type);
+
+    // Furthest a feature reaches from its origin column, features never spill past the adjacent chunks
+    static constexpr int MAX_RADIUS = 2;
+    static_assert(MAX_RADIUS < Constants::CHUNK_SIZE_X && MAX_RADIUS < Constants::CHUNK_SIZE_Z, "Features may only spill into adjacent chunks");
+
+private:
+    const TerrainGenerator &terrainGenerator_;
+    const uint32_t seed_;
+
+    uint32_t hashColumn(int worldX, int worldZ, uint32_t salt) const;
+    void placeTree(const glm::ivec3 &base, uint32_t hash, std::vector<FeatureBlock> &out) const;
+    void placeBoulder(const glm::ivec3 &center, uint32_t hash, std::vector<FeatureBlock> &out) const;
+
+    // Higher wins when two features want the same block, 0 for blocks features never replace
+    static constexpr int getPriority(BlockType type)
+    {
+        switch (type)
+        {
+        case BlockType::Leaves:
+            return 1;
+        case BlockType::Log:
+            return 2;
+        case BlockType::Cobblestone:
+            return 3;
+        default:
+            return 0;
+        }
+    }
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Constants.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+// FIFO of light BFS nodes for a single chunk. A node is the block's chunk local position and the
+// light level it was queued with, packed into 32 bits: x in bits 0-3, z in 4-7, y in 8-15, light in 16-19.
+// Stored in a power of two ring buffer that only grows, so a queue reused across calls stops allocating
+class LightQueue
+{
+public:
+    explicit LightQueue(size_t capacity = Constants::CHUNK_SIZE_X * Constants::CHUNK_SIZE_Y * Constants::CHUNK_SIZE_Z)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        nodes_.resize(size);
+    }
+
+    static inline uint32_t pack(int x, int y, int z, int light)
+    {
+        return static_cast<uint32_t>(x | (z << 4) | (y << 8) | (light << 16));
+    }
+    static inline glm::ivec3 getPos(uint32_t node)
+    {
+        return glm::ivec3(static_cast<int>(node & 0xF), static_cast<int>((node >> 8) & 0xFF), static_cast<int>((node >> 4) & 0xF));
+    }
+    static inline int getLight(uint32_t node) { return static_cast<int>((node >> 16) & 0xF); }
+
+    inline void push(uint32_t node)
+    {
+        if (tail_ - head_ == nodes_.size())
+            grow();
+        nodes_[tail_++ & (nodes_.size() - 1)] = node;
+    }
+
+    inline uint32_t pop()
+    {
+        popCount_++;
+        return nodes_[head_++ & (nodes_.size() - 1)];
+    }
+
+    inline bool empty() const { return head_ == tail_; }
+
+    // Empties the queue and restarts the pop count, keeps the buffer
+    void clear()
+    {
+        head_ = tail_ = 0;
+        popCount_ = 0;
+    }
+
+    // Nodes popped since the last clear
+    inline size_t getPopCount() const { return popCount_; }
+
+private:
+    std::vector<uint32_t> nodes_;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+    size_t popCount_ = 0;
+
+    // Doubles the buffer, unwrapping the queued nodes to its start
+    void grow()
+    {
+        const size_t count = tail_ - head_;
+        std::vector<uint32_t> nodes(nodes_.size() * 2);
+        for (size_t i = 0; i < count; i++)
+            nodes[i] = nodes_[(head_ + i) & (nodes_.size() - 1)];
+        nodes_.swap(nodes);
+        head_ = 0;
+        tail_ = count;
+    }
+};
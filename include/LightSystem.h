@@ -1,37 +1,64 @@
 #pragma once
 
 #include "Block/BlockTypes.h"
-#include "chunk/ChunkCoord.h"
+#include "Block/BlockRegistry.h"
+#include "Chunk/ChunkCoord.h"
+#include "Chunk/ChunkSection.h"
+#include "LightQueue.h"
+#include "Constants.h"
 
 #include <array>
+#include <cstddef>
 #include <memory>
-#include <queue>
+#include <vector>
 
 #include <glm/glm.hpp>
 
-class World;
-class ChunkManager;
 class Chunk;
-class Block;
-
-struct LightNode
-{
-    std::shared_ptr<Chunk> chunk;
-    glm::ivec3 localPos;
-};
 
 class LightSystem
 {
 public:
-    LightSystem(World *world, ChunkManager *manager);
-    // Update the chunk's lighting from its neighbors
-    void updateBorderLighting(std::shared_ptr<Chunk> chunk);
-    // Happens right after terrain gen, only propogates light within chunk
-    void seedInitialSkylight(std::shared_ptr<Chunk> chunk);
+    // Light loses at least a level per block sideways, so nothing lit from inside a chunk or along its
+    // border reaches further than one chunk over. Updates work on the 3x3 chunks around a chunk,
+    // row by row from (x - 1, z - 1) with the chunk itself at 4. Missing chunks are treated as walls
+    using Neighborhood = std::array<std::shared_ptr<Chunk>, 9>;
+    static constexpr int MAX_LIGHT_LEVEL = 15;
+    static_assert(MAX_LIGHT_LEVEL < Constants::CHUNK_SIZE_X && MAX_LIGHT_LEVEL < Constants::CHUNK_SIZE_Z,
+                  "Light must not spread past the chunks next to the one being updated");
+
+    struct LightUpdate
+    {
+        size_t nodes = 0;
+        // Chunks whose light, or whose faces' light, changed and need remeshing
+        std::vector<std::shared_ptr<Chunk>> changedChunks;
+    };
+
+    // How seedInitialSkylight lights a chunk below its open sky. Both give the same light, Bfs goes
+    // a block at a time, Bitwise a 16x16 layer at a time with a bitmask per light level
+    enum class SkylightEngine
+    {
+        Bfs,
+        Bitwise
+    };
+
+    // Evens out sky and block light across the middle chunk's borders in both directions, then
+    // spreads it through all 9 chunks
+    LightUpdate updateBorderLighting(const Neighborhood &chunks);
+    // Happens right after terrain gen, only propogates light within chunk. Returns the BFS nodes
+    // propagated, or the blocks lit by the bitwise engine
+    size_t seedInitialSkylight(std::shared_ptr<Chunk> chunk);
+    void setSkylightEngine(SkylightEngine engine) { skylightEngine_ = engine; }
+    // Lights the chunk's emissive blocks, spreading within the chunk only
+    size_t seedInitialBlocklight(std::shared_ptr<Chunk> chunk);
+    // Fixes light around a block of the middle chunk that was just placed or removed: darkens what
+    // the block used to light, then fills the dark area back in from its edges
+    LightUpdate updateBlockLight(const Neighborhood &chunks, const glm::ivec3 &localPos);
 
 private:
-    World *world_;
-    ChunkManager *chunkManager_;
+    class ChunkWindow;
+
+    SkylightEngine skylightEngine_ = SkylightEngine::Bitwise;
 
     static constexpr std::array<glm::ivec3, 6>
         directions = {
@@ -39,7 +66,19 @@ private:
             glm::ivec3(0, 1, 0), glm::ivec3(0, -1, 0),
             glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1)};
 
-    void seedFromNeighborChunks(std::shared_ptr<Chunk> chunk, std::queue<LightNode> &lightQueue);
-    void clearChunkLightLevels(std::shared_ptr<Chunk> chunk);
-    inline bool isTransparent(BlockType type) const { return type == BlockType::Air; }
+    // Light reaching a neighbor block, skylight doesn't dim going straight down
+    static inline int getPropagatedLight(int currLight, const glm::ivec3 &dir, BlockType neighborType, LightChannel channel)
+    {
+        const int falloff = channel == LightChannel::Sky && dir.y == -1 ? 0 : 1;
+        return currLight - falloff - BlockRegistry::getLightAttenuation(neighborType);
+    }
+
+    // Initial sky light below the fully lit sections from skyStartSection up
+    size_t propagateSkylightBfs(Chunk &chunk, int skyStartSection);
+    size_t propagateSkylightBitwise(Chunk &chunk, int skyStartSection);
+    void seedAcrossBorders(ChunkWindow &window, LightChannel channel, LightQueue &lightQueue);
+    // Spreads the queued light through the chunk, never going up while spreadUp is off
+    void propagateLight(Chunk &chunk, LightQueue &lightQueue, LightChannel channel, bool spreadUp);
+    // Same across the whole window, nodes are window positions
+    void propagateWindowLight(ChunkWindow &window, LightQueue &lightQueue, LightChannel channel);
 };
\ No newline at end of file
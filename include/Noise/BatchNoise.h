@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+// Batched FastNoiseLite: fills a whole span of samples per call using SIMD kernels.
+// The kernel is picked at compile time from the instruction set BatchNoise.cpp is built for, AVX2 (8 lanes),
+// SSE2 (4 lanes) or scalar, see NOISE_SIMD in CMakeLists.txt. Define NOISE_SIMD_SCALAR to force scalar.
+// Results match FastNoiseLite::GetNoise for the same seed and frequency exactly, the noise_check_*
+// tools check every kernel.
+namespace BatchNoise
+{
+    // FastNoiseLite::GetNoise(x, y) with NoiseType_Perlin and no fractal
+    void perlin2D(int seed, float frequency, const float *x, const float *y, float *out, size_t count);
+    // FastNoiseLite::GetNoise(x, y, z) with NoiseType_OpenSimplex2, no fractal and the default 3D rotation
+    void openSimplex2_3D(int seed, float frequency, const float *x, const float *y, const float *z, float *out, size_t count);
+
+    // "AVX2", "SSE2" or "Scalar"
+    const char *getKernelName();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Constants.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Bounded LRU cache of square tiles of a 2D noise function, keyed by region coordinates.
+// Neighboring chunks inside the same region share one tile instead of resampling the noise.
+// Safe to use from any thread, tiles are computed outside the lock and immutable once cached
+class NoiseTileCache
+{
+public:
+    static constexpr int TILE_SIZE = Constants::NOISE_TILE_SIZE;
+    using Tile = std::array<float, TILE_SIZE * TILE_SIZE>;
+    // Fills a tile from the noise function, origin is the tile's min corner in world coords, x changes fastest
+    using TileFiller = std::function<void(int originX, int originZ, Tile &tile)>;
+
+    NoiseTileCache(std::string name, size_t capacity, TileFiller filler);
+
+    std::shared_ptr<const Tile> getTile(int regionX, int regionZ);
+    // Copies a sizeX by sizeZ block of samples starting at world (x, z) into out, x changes fastest
+    void sample(int x, int z, int sizeX, int sizeZ, float *out);
+
+    // Hit rate to the profiler, once per frame rather than per lookup
+    void reportStats() const;
+
+    // Region holding a world coordinate, rounds towards negative infinity
+    static inline int getRegion(int coord) { return coord >= 0 ? coord / TILE_SIZE : (coord + 1) / TILE_SIZE - 1; }
+
+private:
+    using Key = int64_t;
+    struct Entry
+    {
+        std::shared_ptr<const Tile> tile;
+        std::list<Key>::iterator lruPosition;
+    };
+
+    const std::string name_;
+    const size_t capacity_;
+    const TileFiller filler_;
+
+    std::unordered_map<Key, Entry> tiles_;
+    std::list<Key> lru_; // Most recently used at the front
+    std::mutex mutex_;
+
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+
+    // Shifted as unsigned, shifting a negative signed value is undefined before C++20
+    static inline Key makeKey(int regionX, int regionZ)
+    {
+        return static_cast<Key>((static_cast<uint64_t>(static_cast<uint32_t>(regionX)) << 32) | static_cast<uint32_t>(regionZ));
+    }
+};
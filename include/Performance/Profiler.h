@@ -12,12 +12,15 @@ private:
     ~Profiler();
 
     std::unordered_map<std::string, std::vector<double>> timings_;
+    std::unordered_map<std::string, double> values_;
     std::mutex timingsMutex_;
 
 public:
     static Profiler &get();
 
     void record(const std::string &name, const double duration);
+    // Latest value of a stat that isn't a timing (counts, sizes, ratios)
+    void recordValue(const std::string &name, const double value);
     void renderStats();
 
     Profiler(const Profiler &) = delete;
@@ -1,16 +1,94 @@
 #pragma once
 
+#include "Constants.h"
+#include "Biome.h"
+#include "Block/BlockTypes.h"
 #include "FastNoiseLite.h"
+#include "Noise/NoiseTileCache.h"
 
+#include <array>
+#include <cstddef>
+
+// Surface height and biome blended generation parameters of one world column
+struct TerrainColumn
+{
+    int height;
+    int stoneLevel;
+    float caveThreshold;
+    BiomeType biome; // Closest biome
+    BlockType surfaceBlock;
+    BlockType fillerBlock;
+};
+
+// Immutable after construction, one instance is shared by the whole world and every query is
+// const so it can be called from any thread. The noise tile caches are internally synchronized
 class TerrainGenerator
 {
 public:
-    TerrainGenerator();
+    explicit TerrainGenerator(int seed = Constants::WORLD_SEED);
+
+    float getTerrainNoise(const float x, const float z) const;
+    float getCaveNoise(const float x, const float y, const float z) const;
+
+    // Batched versions of the above, same results for a whole span of samples at once
+    void getTerrainNoiseBatch(const float *x, const float *z, float *out, size_t count) const;
+    void getCaveNoiseBatch(const float *x, const float *y, const float *z, float *out, size_t count) const;
 
-    float getTerrainNoise(const float x, const float z);
-    float getCaveNoise(const float x, const float y, const float z);
+    // Columns of a sizeX by sizeZ block starting at (x, z), x changes fastest
+    void getColumnGrid(const int x, const int z, const int sizeX, const int sizeZ, TerrainColumn *out) const;
+
+    // Noise tile cache hit rates to the profiler
+    void reportStats() const;
 
 private:
+    // Kept alongside the FastNoiseLite instances so the batched kernels use identical settings
+    static constexpr float TERRAIN_FREQUENCY = 0.01f;
+    static constexpr float CAVE_FREQUENCY = 1.0f;
+    // Batches are processed in blocks of this many samples so scratch space stays on the stack
+    static constexpr size_t BATCH_BLOCK = 256;
+
+    void fillTerrainNoiseTile(int originX, int originZ, NoiseTileCache::Tile &tile) const;
+    // Climate is only sampled every BIOME_GRID_SIZE blocks, the rest of the tile is interpolated
+    void fillClimateTile(const FastNoiseLite &noise, int originX, int originZ, NoiseTileCache::Tile &tile) const;
+    static TerrainColumn blendBiomes(float heightNoise, float temperature, float humidity);
+
+    static_assert(NoiseTileCache::TILE_SIZE % Constants::BIOME_GRID_SIZE == 0, "Biome grid must divide the noise tile size");
+
+    const int seed_;
     FastNoiseLite terrainNoise;
     FastNoiseLite caveNoise;
-};
\ No newline at end of file
+    FastNoiseLite temperatureNoise;
+    FastNoiseLite humidityNoise;
+    // Whole terrain height noise per 64x64 region, neighboring chunks read the same tile
+    mutable NoiseTileCache heightNoiseTiles_;
+    mutable NoiseTileCache temperatureTiles_;
+    mutable NoiseTileCache humidityTiles_;
+};
+
+// Cave density for one chunk, sampled on a coarse lattice and trilinearly interpolated in between.
+// Lattice spacing is set by CAVE_LATTICE_XZ and CAVE_LATTICE_Y, the lattice includes the chunk's far
+// edges so neighboring chunks agree on the shared samples
+class CaveDensityGrid
+{
+public:
+    // Samples the lattice layers around minY to maxY, from the last one at or below minY
+    // up to the first one at or above maxY
+    void build(const TerrainGenerator &generator, int chunkWorldX, int chunkWorldZ, int minY, int maxY);
+    // Interpolated density at a chunk local position, y must be within the range it was built with
+    float sample(int x, int y, int z) const;
+
+private:
+    static constexpr int STEP_XZ = Constants::CAVE_LATTICE_XZ;
+    static constexpr int STEP_Y = Constants::CAVE_LATTICE_Y;
+    static constexpr int POINTS_X = Constants::CHUNK_SIZE_X / STEP_XZ + 1;
+    static constexpr int POINTS_Z = Constants::CHUNK_SIZE_Z / STEP_XZ + 1;
+    static constexpr int POINTS_Y = Constants::CHUNK_SIZE_Y / STEP_Y + 1;
+
+    static_assert(Constants::CHUNK_SIZE_X % STEP_XZ == 0 && Constants::CHUNK_SIZE_Z % STEP_XZ == 0,
+                  "Cave lattice must divide the chunk width");
+    static_assert(Constants::CHUNK_SIZE_Y % STEP_Y == 0, "Cave lattice must divide the chunk height");
+
+    std::array<float, POINTS_X * POINTS_Y * POINTS_Z> samples_;
+
+    static inline int getSampleIndex(int lx, int ly, int lz) { return lx + lz * POINTS_X + ly * POINTS_X * POINTS_Z; }
+};
@@ -3,8 +3,7 @@
 #include "Block/BlockTypes.h"
 #include "Block/BlockFaceData.h"
 
-#include <unordered_map>
-#include <vector>
+#include <array>
 
 #include <glm/glm.hpp>
 
@@ -14,6 +13,8 @@ public:
     unsigned int ID_;
 
     TextureAtlas();
+    // Face UVs only, for tools that build meshes without a GL context
+    TextureAtlas(int atlasWidth, int atlasHeight);
     void bindUnit(unsigned int unit);
     const std::array<glm::vec2, 4> &getBlockFaceUVs(BlockType type, BlockFaces face) const;
 
@@ -21,7 +22,8 @@ private:
     int atlasWidth_;
     int atlasHeight_;
     int tileSize_;
-    std::unordered_map<BlockType, BlockUVs> blockUVsMap_;
+    // UVs for every block face, indexed by [BlockType][BlockFaces]
+    std::array<std::array<std::array<glm::vec2, 4>, 6>, BlockTypeCount> faceUVs_;
 
     void initBlockUVs();
     std::array<glm::vec2, 4> getTileUVs(int tileX, int tileY);
@@ -6,12 +6,15 @@
 #include "Block/BlockOutline.h"
 #include "Block/BlockTypes.h"
 #include "Raycaster.h"
+#include "TerrainGenerator.h"
+#include "FeatureGenerator.h"
 #include "Constants.h"
 
 #include <glm/glm.hpp>
 
+#include <optional>
+
 struct ChunkCoord;
-class Block;
 class Camera;
 class Shader;
 class TextureAtlas;
@@ -28,11 +31,15 @@ public:
     void placeBlock();
     void setPlayerBlockType(BlockType type);
 
-    Block *getBlockGlobal(const glm::ivec3 worldPos) const;
+    // Empty if the block's chunk isn't loaded or the position is outside the world height
+    std::optional<BlockType> getBlockGlobal(const glm::ivec3 worldPos) const;
     bool isBlockSolid(glm::ivec3 blockWorldPos) const;
+    // Y of the highest non-air block in a world column, -1 if the column is empty or not loaded
+    int getSurfaceHeight(int worldX, int worldZ) const;
     glm::ivec3 localToGlobalPos(ChunkCoord chunkCoords, glm::ivec3 localPos) const;
 
     const std::shared_ptr<Chunk> getChunk(const ChunkCoord &coord) const;
+    size_t getChunkMemoryUsage();
     // Coordinate conversions
     glm::ivec3 chunkToWorldCoords(ChunkCoord chunkCoords, glm::ivec3 localPos) const;
     ChunkCoord worldToChunkCoords(glm::ivec3 worldCoords) const;
@@ -40,9 +47,12 @@ public:
 
 private:
     Camera &camera_;
-    ChunkPipeline pipeline_;
+    const TerrainGenerator terrainGenerator_;
+    const FeatureGenerator featureGenerator_;
     ChunkManager chunkManager_;
     LightSystem lightSystem_;
+    // After everything its workers use so it's destroyed, and its workers joined, first
+    ChunkPipeline pipeline_;
     ChunkCoord lastPlayerChunk_;
     BlockType playerBlockType_ = BlockType::Dirt;
     Raycaster raycaster;
@@ -53,6 +63,11 @@ private:
     void loadNewChunks(ChunkCoord center);
     void unloadDistantChunks();
     void updateSelectedBlockOutline();
+    // Null until the chunk's initial light is done. Until then a worker may still be writing its
+    // blocks, the light pass generates placeholder sections that sky light reaches
+    std::shared_ptr<Chunk> getGeneratedChunk(const ChunkCoord &coord) const;
+    // Null unless the chunk is done with the pipeline, only those can be edited
+    std::shared_ptr<Chunk> getLoadedChunk(const ChunkCoord &coord) const;
 
     static inline bool isInRenderDistance(int chunkX, int chunkZ, int playerX, int playerZ)
     {
@@ -3,6 +3,7 @@
 in vec2 TexCoord;
 in float AO;
 in float Skylight;
+in float Blocklight;
 
 out vec4 FragColor;
 
@@ -12,8 +13,13 @@ uniform sampler2D texture1;
 void main()
 {	
 	vec4 textureColor = texture(texture1, TexCoord);
-	// Blocks with Skylight 0 get mininmun light val
-	float lightLevel = max(Skylight, 0.15) * AO;
-	textureColor.rgb *= lightLevel;  
+	// Cut out the see-through texels of glass and leaves
+	if (textureColor.a < 0.1)
+		discard;
+	// Whichever channel is brighter wins, block light has a warm tint.
+	// Unlit blocks get a minimum light val
+	vec3 lightColor = max(vec3(Skylight), Blocklight * vec3(1.0, 0.9, 0.7));
+	lightColor = max(lightColor, vec3(0.15)) * AO;
+	textureColor.rgb *= lightColor;
 	FragColor = textureColor;
 }
\ No newline at end of file
@@ -2,11 +2,12 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 layout (location = 2) in float aAO;
-layout (location = 3) in float aSkylight;
+layout (location = 3) in float aLight; // Sky light + block light * 16
 
 out vec2 TexCoord;
 out float AO;
 out float Skylight;
+out float Blocklight;
 
 uniform mat4 model;
 uniform mat4 view;
@@ -17,6 +18,7 @@ void main()
 	gl_Position = projection * view * model * vec4(aPos, 1.0);
 	TexCoord = vec2(aTexCoord.x, aTexCoord.y);
 	AO = aAO;
-	Skylight = aSkylight;
+	Skylight = mod(aLight, 16.0) / 15.0;
+	Blocklight = floor(aLight / 16.0) / 15.0;
 }
 
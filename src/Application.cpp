@@ -3,7 +3,6 @@
 #include "OpenGL/VertexArray.h"
 #include "TextureAtlas.h"
 #include "Block/BlockTypes.h"
-#include "Block/Block.h"
 
 #include "Performance/Profiler.h"
 
@@ -173,7 +172,7 @@ void Application::updateFPS(const float dt)
 void Application::setupImGuiUI()
 {
     ImGui::Begin("Stats");
-    ImGui::SetWindowSize(ImVec2(350, 150));
+    ImGui::SetWindowSize(ImVec2(350, 170));
     ImGui::Text("FPS: %.1f", fpsToDisplay_);
 
     glm::vec3 camPos = camera_->Position;
@@ -186,6 +185,7 @@ void Application::setupImGuiUI()
 
     float zoom = camera_->Zoom;
     ImGui::Text("FOV: (%.2f)", zoom);
+    ImGui::Text("Chunk Memory: %.2f MB (%s layout)", world_->getChunkMemoryUsage() / (1024.0 * 1024.0), ChunkBlockLayout::name);
 
     ImGui::End();
 }
@@ -1,5 +0,0 @@
-#include "Block/Block.h"
-
-Block::Block() : type(BlockType::Air), position(glm::ivec3(0.0f)), skylight(0) {}
-
-Block::Block(BlockType type, glm::ivec3 pos) : type(type), position(pos), skylight(0) {}
\ No newline at end of file
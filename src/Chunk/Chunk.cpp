@@ -1,70 +1,209 @@
 #include "Chunk/Chunk.h"
 #include "Block/BlockTypes.h"
 #include "Block/BlockFaceData.h"
+#include "TerrainGenerator.h"
 #include "Performance/ScopedTimer.h"
 
 #include <glm/glm.hpp>
 
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
-Chunk::Chunk(Shader &chunkShader, TextureAtlas &atlas, ChunkCoord pos)
-    : mesh_(chunkShader), textureAtlas_(atlas), chunkCoord_(pos)
+Chunk::Chunk(Shader *chunkShader, ChunkCoord pos)
+    : chunkCoord_(pos), chunkShader_(chunkShader)
+{
+    opaqueRows_.fill(0);
+    heightMap_.fill(-1);
+    setCoord(pos);
+}
+
+void Chunk::reset(ChunkCoord pos)
+{
+    for (auto &section : sections_)
+        section.reset();
+
+    opaqueRows_.fill(0);
+    heightMap_.fill(-1);
+    maxHeight_ = -1;
+    minHeight_ = -1;
+    ungeneratedSections_ = 0;
+
+    for (auto &mesh : sectionMeshes_)
+    {
+        if (mesh)
+            mesh->reset();
+    }
+    markAllSectionsDirty();
+    stateMachine_.reset();
+    setCoord(pos);
+}
+
+void Chunk::setCoord(ChunkCoord pos)
 {
     const int chunkSize_X = Constants::CHUNK_SIZE_X;
     const int chunkSize_Y = Constants::CHUNK_SIZE_Y;
     const int chunkSize_Z = Constants::CHUNK_SIZE_Z;
 
-    blocks_.resize(chunkSize_X * chunkSize_Y * chunkSize_Z);
-
+    chunkCoord_ = pos;
     boundingBox_.min = glm::vec3(chunkCoord_.x * chunkSize_X, 0, chunkCoord_.z * chunkSize_Z);
     boundingBox_.max = glm::vec3(chunkCoord_.x * chunkSize_X + chunkSize_X, chunkSize_Y, chunkCoord_.z * chunkSize_Z + chunkSize_Z);
 }
 
-void Chunk::generateTerrain()
+void Chunk::generateTerrain(const TerrainGenerator &generator)
+{
+    using namespace Constants;
+    ScopedTimer timer("Chunk::generateTerrain");
+
+    // Pass 1: height and biome only depend on the column, look them up once per column
+    std::array<TerrainColumn, CHUNK_SIZE_X * CHUNK_SIZE_Z> columns;
+    getTerrainColumns(generator, columns.data());
+
+    int highestSurface = 0;
+    int lowestSurface = CHUNK_SIZE_Y - 1;
+    for (const auto &column : columns)
+    {
+        highestSurface = std::max(highestSurface, column.height);
+        lowestSurface = std::min(lowestSurface, column.height);
+    }
+
+    // Sections wholly below every column's surface, less a margin for caves to reach into,
+    // start out as placeholder stone. Nothing sees them until a cave, edit or raycast gets there
+    const int firstSection = std::max(lowestSurface - LAZY_SECTION_MARGIN, 0) / SECTION_SIZE;
+    const int firstY = firstSection * SECTION_SIZE;
+    for (int i = 0; i < firstSection; i++)
+    {
+        sections_[i].fill(PLACEHOLDER_BLOCK);
+        ungeneratedSections_ |= static_cast<uint16_t>(1 << i);
+    }
+    std::fill(opaqueRows_.begin(), opaqueRows_.begin() + getRowIndex(firstY, 0), FULL_ROW);
+
+    // Pass 2: fill each column up to its surface, everything above stays air
+    fillColumns(generator, columns.data(), firstY, highestSurface);
+
+    for (int z = 0; z < CHUNK_SIZE_Z; z++)
+    {
+        for (int x = 0; x < CHUNK_SIZE_X; x++)
+        {
+            // Usually the surface block, unless a cave took it
+            int y = columns[x + z * CHUNK_SIZE_X].height;
+            while (y >= firstY && getBlockType({x, y, z}) == BlockType::Air)
+                y--;
+            heightMap_[x + z * CHUNK_SIZE_X] = static_cast<int16_t>(y);
+        }
+    }
+    updateHeightBounds();
+
+    // Collapse sections that ended up a single block type (sky, deep stone)
+    for (int i = firstSection; i < SECTIONS_PER_CHUNK; i++)
+        sections_[i].compact();
+}
+
+bool Chunk::materializeSection(int index, const TerrainGenerator &generator)
+{
+    using namespace Constants;
+
+    if (isSectionGenerated(index))
+        return false;
+    ScopedTimer timer("Chunk::materializeSection");
+
+    std::array<TerrainColumn, CHUNK_SIZE_X * CHUNK_SIZE_Z> columns;
+    getTerrainColumns(generator, columns.data());
+
+    const int minY = index * SECTION_SIZE;
+    sections_[index].reset();
+    std::fill(opaqueRows_.begin() + getRowIndex(minY, 0), opaqueRows_.begin() + getRowIndex(minY + SECTION_SIZE, 0), 0);
+    fillColumns(generator, columns.data(), minY, minY + SECTION_SIZE - 1);
+
+    // Columns whose cave ran down onto the placeholder had their height stop on top of it
+    const int16_t topY = static_cast<int16_t>(minY + SECTION_SIZE - 1);
+    for (int z = 0; z < CHUNK_SIZE_Z; z++)
+    {
+        for (int x = 0; x < CHUNK_SIZE_X; x++)
+        {
+            int16_t &height = heightMap_[x + z * CHUNK_SIZE_X];
+            if (height != topY)
+                continue;
+            while (height >= 0 && getBlockType({x, height, z}) == BlockType::Air)
+                height--;
+        }
+    }
+    updateHeightBounds();
+
+    sections_[index].compact();
+
+    ungeneratedSections_ &= static_cast<uint16_t>(~(1 << index));
+    // Faces on the sections next to it may face into new caves
+    dirtySections_ |= static_cast<uint16_t>((0b111 << index) >> 1);
+    return true;
+}
+
+int Chunk::findLitPlaceholderSection() const
 {
     using namespace Constants;
 
-    for (int x = 0; x < CHUNK_SIZE_X; x++)
+    for (int i = SECTIONS_PER_CHUNK - 2; i >= 0; i--)
     {
+        if (isSectionGenerated(i) || !isSectionGenerated(i + 1))
+            continue;
+
+        const int y = (i + 1) * SECTION_SIZE;
         for (int z = 0; z < CHUNK_SIZE_Z; z++)
         {
-            for (int y = 0; y < CHUNK_SIZE_Y; y++)
+            // Only rows with an opening need their light checked
+            const uint16_t openRow = static_cast<uint16_t>(~opaqueRows_[getRowIndex(y, z)] & FULL_ROW);
+            for (int x = 0; x < CHUNK_SIZE_X; x++)
             {
+                if ((openRow >> x) & 1 && getSkylight({x, y, z}) > 0)
+                    return i;
+            }
+        }
+    }
+    return -1;
+}
 
-                float worldX = chunkCoord_.x * CHUNK_SIZE_X + x;
-                float worldZ = chunkCoord_.z * CHUNK_SIZE_Z + z;
+void Chunk::getTerrainColumns(const TerrainGenerator &generator, TerrainColumn *columns) const
+{
+    using namespace Constants;
 
-                float terrainNoise = terrainGen_.getTerrainNoise(worldX, worldZ); // [0 - 1]
-                float centeredNoise = terrainNoise - 0.5f;                        // -0.5 to 0.5
-                int height = TERRAIN_BASE_HEIGHT + (int)(centeredNoise * TERRAIN_HEIGHT_VARIATION * 2.0f);
+    const int chunkWorldX = chunkCoord_.x * CHUNK_SIZE_X;
+    const int chunkWorldZ = chunkCoord_.z * CHUNK_SIZE_Z;
+    generator.getColumnGrid(chunkWorldX, chunkWorldZ, CHUNK_SIZE_X, CHUNK_SIZE_Z, columns);
+    for (int i = 0; i < CHUNK_SIZE_X * CHUNK_SIZE_Z; i++)
+        columns[i].height = std::clamp(columns[i].height, 0, CHUNK_SIZE_Y - 1);
+}
+
+void Chunk::fillColumns(const TerrainGenerator &generator, const TerrainColumn *columns, int minY, int maxY)
+{
+    using namespace Constants;
+
+    // Cave density on a coarse lattice, only over the layers being filled.
+    // Caves only carve below the surface so sky voxels never pay for 3D noise
+    CaveDensityGrid caveDensity;
+    caveDensity.build(generator, chunkCoord_.x * CHUNK_SIZE_X, chunkCoord_.z * CHUNK_SIZE_Z, minY, maxY);
+
+    for (int z = 0; z < CHUNK_SIZE_Z; z++)
+    {
+        for (int x = 0; x < CHUNK_SIZE_X; x++)
+        {
+            const TerrainColumn &column = columns[x + z * CHUNK_SIZE_X];
+            const int topY = std::min(column.height, maxY);
+            for (int y = minY; y <= topY; y++)
+            {
+                if (y > 0 && caveDensity.sample(x, y, z) > column.caveThreshold)
+                    continue;
 
                 BlockType type;
-                if (y > height)
-                {
-                    type = BlockType::Air;
-                }
-                else if (y == height)
-                {
-                    type = BlockType::Grass;
-                }
-                else if (y < height && y > STONE_LEVEL)
-                {
-                    type = BlockType::Dirt;
-                }
+                if (y == column.height)
+                    type = column.surfaceBlock;
+                else if (y > column.stoneLevel)
+                    type = column.fillerBlock;
                 else
-                {
                     type = BlockType::Stone;
-                }
-
-                // Cave generation
-                float caveVal = terrainGen_.getCaveNoise(worldX, (float)y, worldZ);
-                if (y <= height && caveVal > CAVE_THRESHOLD && y > 0)
-                    type = BlockType::Air;
 
-                glm::ivec3 pos = {x, y, z};
-                const size_t index = getBlockIndex(pos);
-                blocks_[index] = Block(type, pos);
+                getSectionAt(y).setBlock(getSectionBlockIndex({x, y, z}), type);
+                if (isOpaqueBlock(type))
+                    opaqueRows_[getRowIndex(y, z)] |= 1 << x;
             }
         }
     }
@@ -72,39 +211,106 @@ void Chunk::generateTerrain()
 
 void Chunk::removeBlockAt(glm::ivec3 pos)
 {
-    const size_t index = getBlockIndex(pos);
-    blocks_[index] = Block(BlockType::Air, pos);
+    getSectionAt(pos.y).setBlock(getSectionBlockIndex(pos), BlockType::Air);
+    updateOpacity(pos, BlockType::Air);
+    updateHeightMap(pos, BlockType::Air);
+    markBlockDirty(pos);
 }
 
 void Chunk::setBlockAt(glm::ivec3 pos, BlockType type)
 {
-    const size_t index = getBlockIndex(pos);
-    blocks_[index] = Block(type, pos);
+    getSectionAt(pos.y).setBlock(getSectionBlockIndex(pos), type);
+    updateOpacity(pos, type);
+    updateHeightMap(pos, type);
+    markBlockDirty(pos);
 }
 
-Block *Chunk::getBlockLocal(const glm::ivec3 &pos)
+void Chunk::updateOpacity(const glm::ivec3 &pos, BlockType type)
 {
-    if (!blockPosInChunkBounds(pos))
-        return nullptr;
+    uint16_t &row = opaqueRows_[getRowIndex(pos.y, pos.z)];
+    if (isOpaqueBlock(type))
+        row |= 1 << pos.x;
+    else
+        row &= ~(1 << pos.x);
+}
 
-    const size_t index = getBlockIndex(pos);
-    return &blocks_[index];
+void Chunk::updateHeightMap(const glm::ivec3 &pos, BlockType type)
+{
+    int16_t &height = heightMap_[pos.x + pos.z * Constants::CHUNK_SIZE_X];
+    const int oldHeight = height;
+
+    if (type != BlockType::Air)
+    {
+        if (pos.y > height)
+            height = static_cast<int16_t>(pos.y);
+    }
+    // Removed the top block, walk down to the next non-air one
+    else if (pos.y == height)
+    {
+        int y = pos.y - 1;
+        while (y >= 0 && getBlockType({pos.x, y, pos.z}) == BlockType::Air)
+            y--;
+        height = static_cast<int16_t>(y);
+    }
+
+    if (height != oldHeight)
+        updateHeightBounds();
+}
+
+void Chunk::updateHeightBounds()
+{
+    const auto [minIt, maxIt] = std::minmax_element(heightMap_.begin(), heightMap_.end());
+    minHeight_ = *minIt;
+    maxHeight_ = *maxIt;
+}
+
+void Chunk::clearSkylight()
+{
+    for (auto &section : sections_)
+        section.fillSkylight(0);
+    markAllSectionsDirty();
+}
+
+void Chunk::clearBlocklight()
+{
+    for (auto &section : sections_)
+        section.fillBlocklight(0);
+    markAllSectionsDirty();
 }
 
-std::vector<Block> &Chunk::getBlocks()
+bool Chunk::isSectionUniformSolid(int index) const
 {
-    return blocks_;
+    const ChunkSection &section = sections_[index];
+    return section.isUniform() && isOpaqueBlock(section.getUniformBlock());
+}
+
+size_t Chunk::getMemoryUsage() const
+{
+    size_t bytes = sizeof(Chunk) - sizeof(sections_);
+    for (const auto &section : sections_)
+        bytes += section.getMemoryUsage();
+    for (const auto &mesh : sectionMeshes_)
+    {
+        if (mesh)
+            bytes += sizeof(ChunkMesh) + mesh->getMemoryUsage();
+    }
+    return bytes;
 }
 
-ChunkMesh &Chunk::getMesh()
+void Chunk::setSectionMeshData(int index, MeshData &&newMeshData)
 {
-    return mesh_;
+    auto &mesh = sectionMeshes_[index];
+    if (!mesh)
+        mesh = std::make_unique<ChunkMesh>(*chunkShader_);
+    mesh->meshData_ = std::move(newMeshData);
 }
 
-void Chunk::setMeshData(MeshData &newMeshData)
+BoundingBox Chunk::getSectionBoundingBox(int index) const
 {
-    mesh_.meshData_ = newMeshData;
-    mesh_.setMeshValid();
+    BoundingBox box = boundingBox_;
+    box.min.y = static_cast<float>(index * Constants::SECTION_SIZE);
+    box.max.y = box.min.y + Constants::SECTION_SIZE;
+    return box;
 }
 
 const ChunkCoord Chunk::getCoord() const
@@ -8,7 +8,8 @@
 ChunkManager::ChunkManager(Camera &camera)
     : camera_(camera),
       chunkShader_("../shaders/chunk.vert", "../shaders/chunk.frag"),
-      textureAtlas_()
+      textureAtlas_(),
+      chunkPool_(&chunkShader_, Constants::CHUNK_POOL_SIZE, Constants::MESH_SCRATCH_POOL_SIZE)
 {
 }
 
@@ -19,20 +20,38 @@ void ChunkManager::init(ChunkPipeline *pipeline)
 
 void ChunkManager::addChunk(const ChunkCoord &coord)
 {
-    auto chunk = std::make_shared<Chunk>(chunkShader_, textureAtlas_, coord);
+    auto chunk = chunkPool_.acquire(coord);
     chunks_[coord] = chunk;
     readyForTerrainGen_.insert(chunk);
 }
 
 void ChunkManager::removeChunk(const ChunkCoord &coord)
 {
-    chunks_.erase(coord);
+    auto it = chunks_.find(coord);
+    if (it == chunks_.end())
+        return;
+
+    auto chunk = std::move(it->second);
+    chunks_.erase(it);
+
+    readyForTerrainGen_.erase(chunk);
+    readyForInitLighting_.erase(chunk);
+    readyForFinalLighting_.erase(chunk);
+    readyForMeshing_.erase(chunk);
+    readyForUpload_.erase(chunk);
+    readyForRemesh_.erase(chunk);
+    pipeline_->onChunkRemoved(coord);
+
+    chunkPool_.release(std::move(chunk));
 }
 
 void ChunkManager::update()
 {
     processBatches();
+    pipeline_->processCompletedTasks();
+    pipeline_->applyLateFeatureWrites();
     processStateChanges();
+    chunkPool_.reportStats();
 }
 
 void ChunkManager::processBatches()
@@ -42,6 +61,7 @@ void ChunkManager::processBatches()
     auto finalLightBatch = std::move(readyForFinalLighting_);
     auto meshBatch = std::move(readyForMeshing_);
     auto uploadBatch = std::move(readyForUpload_);
+    auto remeshBatch = std::move(readyForRemesh_);
 
     for (const auto &chunk : terrainBatch)
     {
@@ -81,6 +101,20 @@ void ChunkManager::processBatches()
     {
         pipeline_->uploadMeshToGPU(chunk);
     }
+
+    // Loaded chunks with dirty sections, only those sections get rebuilt. Wait for neighbors
+    // still being generated on a worker, their blocks can't be read yet
+    for (const auto &chunk : remeshBatch)
+    {
+        if (allNeighborsStateReady(chunk->getCoord(), ChunkState::INITIAL_LIGHT_READY))
+        {
+            pipeline_->generateMesh(chunk);
+        }
+        else
+        {
+            readyForRemesh_.insert(chunk);
+        }
+    }
 }
 
 void ChunkManager::processStateChanges()
@@ -90,6 +124,10 @@ void ChunkManager::processStateChanges()
         auto event = stateChangeQueue_.front();
         stateChangeQueue_.pop();
 
+        // Chunk was unloaded after the event was queued
+        if (getChunk(event.chunk->getCoord()) != event.chunk)
+            continue;
+
         switch (event.newState)
         {
         case ChunkState::TERRAIN_GENERATED:
@@ -116,14 +154,21 @@ void ChunkManager::processStateChanges()
 
         case ChunkState::LOADED:
             event.chunk->setState(ChunkState::LOADED);
+            // Light or blocks changed by an edit while its mesh was being built
+            if (event.chunk->getDirtySections())
+                readyForRemesh_.insert(event.chunk);
             break;
 
-        // TODO
+        // Blocks changed too much for a per block light update, light it again from scratch.
+        // Chunks still in the pipeline get their light when they reach the light stages
         case ChunkState::NEEDS_LIGHT_UPDATE:
+            pipeline_->relight(event.chunk);
             break;
 
-        // TODO
+        // Chunks still in the pipeline pick up dirty sections when they get meshed
         case ChunkState::NEEDS_MESH_REGEN:
+            if (event.chunk->getState() == ChunkState::LOADED)
+                readyForRemesh_.insert(event.chunk);
             break;
         }
     }
@@ -169,9 +214,13 @@ void ChunkManager::renderAllChunks()
 
 void ChunkManager::renderChunk(std::shared_ptr<Chunk> chunk, const ChunkCoord &pos)
 {
-    ChunkMesh &mesh = chunk->getMesh();
-    if (chunk->getState() == ChunkState::LOADED && mesh.hasValidMesh_)
-        mesh.render(pos);
+    // Sections keep drawing their last upload while they're being remeshed
+    for (int i = 0; i < Constants::SECTIONS_PER_CHUNK; i++)
+    {
+        ChunkMesh *mesh = chunk->getSectionMesh(i);
+        if (mesh && mesh->isDrawable() && camera_.isAABBInFrustum(chunk->getSectionBoundingBox(i)))
+            mesh->render(pos);
+    }
 }
 
 const TextureAtlas &ChunkManager::getTextureAtlasRef() const
@@ -179,6 +228,11 @@ const TextureAtlas &ChunkManager::getTextureAtlasRef() const
     return textureAtlas_;
 }
 
+ChunkPool &ChunkManager::getChunkPool()
+{
+    return chunkPool_;
+}
+
 const std::shared_ptr<Chunk> ChunkManager::getChunk(const ChunkCoord &coord) const
 {
     auto it = chunks_.find(coord);
@@ -10,13 +10,7 @@
 
 ChunkMesh::ChunkMesh(Shader &chunkShader) : chunkShader_(chunkShader)
 {
-    const int chunkSize_X = Constants::CHUNK_SIZE_X;
-    const int chunkSize_Y = Constants::CHUNK_SIZE_Y;
-    const int chunkSize_Z = Constants::CHUNK_SIZE_Z;
-
-    meshData_.vertices_.reserve(chunkSize_X * chunkSize_Y * chunkSize_Z * 4); // Max 4 unique vertices per face
-    meshData_.indices_.reserve(chunkSize_X * chunkSize_Y * chunkSize_Z * 6);  // Max 6 indices per face
-
+    // Mesh buffers are built elsewhere and moved in, sized to the chunk's actual faces
     configureVertexAttributes();
 }
 
@@ -51,9 +45,11 @@ void ChunkMesh::uploadMesh()
     ebo_.bind();
     indicesCount_ = meshData_.indices_.size();
     ebo_.setData(meshData_.indices_.data(), indicesCount_ * sizeof(unsigned int));
+}
 
-    meshData_.vertices_.clear();
-    meshData_.indices_.clear();
+MeshData ChunkMesh::takeMeshData()
+{
+    return std::move(meshData_);
 }
 
 void ChunkMesh::setMeshValid()
@@ -61,6 +57,20 @@ void ChunkMesh::setMeshValid()
     hasValidMesh_.store(true);
 }
 
+void ChunkMesh::reset()
+{
+    hasValidMesh_.store(false);
+    meshData_.vertices_.clear();
+    meshData_.indices_.clear();
+    verticesCount_ = 0;
+    indicesCount_ = 0;
+}
+
+size_t ChunkMesh::getMemoryUsage() const
+{
+    return meshData_.vertices_.capacity() * sizeof(Vertex) + meshData_.indices_.capacity() * sizeof(unsigned int);
+}
+
 void ChunkMesh::configureVertexAttributes()
 {
     vao_.bind();
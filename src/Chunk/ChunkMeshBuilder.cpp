@@ -2,8 +2,10 @@
 #include "Chunk/Chunk.h"
 #include "Chunk/MeshData.h"
 #include "Block/BlockFaceData.h"
+#include "Block/BlockRegistry.h"
 #include "Constants.h"
 #include "TextureAtlas.h"
+#include "Performance/ScopedTimer.h"
 
 #include <glm/glm.hpp>
 #include <iostream>
@@ -13,86 +15,79 @@ ChunkMeshBuilder::ChunkMeshBuilder(MeshData &meshData, const TextureAtlas &atlas
 {
 }
 
-MeshData &ChunkMeshBuilder::buildMesh()
+MeshData &ChunkMeshBuilder::buildSectionMesh(int sectionIndex)
 {
     using namespace Constants;
-    // loop through chunk and generate each blocks mesh
+    ScopedTimer timer("ChunkMeshBuilder::buildSectionMesh");
 
-    for (int x = 0; x < CHUNK_SIZE_X; x++)
-    {
-        for (int y = 0; y < CHUNK_SIZE_Y; y++)
-        {
-            for (int z = 0; z < CHUNK_SIZE_Z; z++)
-            {
-                glm::ivec3 pos = glm::ivec3(x, y, z);
-                Block *blockPtr = chunk_->getBlockLocal(pos);
+    const ChunkSection &section = chunk_->getSection(sectionIndex);
+
+    // Uniform sections can be skipped whole, invisible blocks have nothing to draw and
+    // solid sections boxed in by other solid sections have no visible faces
+    if (section.isUniform() && !BlockRegistry::isVisible(section.getUniformBlock()))
+        return meshData_;
+    if (isSectionHidden(sectionIndex))
+        return meshData_;
 
-                if (!blockPtr)
-                    std::cout << "BlockPtr is null in ChunkMeshBulider::buildMesh()" << std::endl;
+    // Walk the section in storage order so block reads stay sequential for any layout
+    const glm::ivec3 sectionOrigin = glm::ivec3(0, sectionIndex * SECTION_SIZE, 0);
+    for (int i = 0; i < ChunkSection::VOLUME; i++)
+    {
+        BlockType type = section.getBlock(i);
+        if (!BlockRegistry::isVisible(type))
+            continue;
 
-                Block &block = *blockPtr;
-                if (block.type == BlockType::Air)
-                    continue;
-                if (isBlockHiddenByNeighbors(pos))
-                    continue;
+        glm::ivec3 pos = sectionOrigin + ChunkSection::getBlockPosition(i);
+        if (isBlockHiddenByNeighbors(pos))
+            continue;
 
-                generateBlockMesh(block);
-            }
-        }
+        generateBlockMesh(pos, type);
     }
 
     return meshData_;
 }
 
-void ChunkMeshBuilder::generateBlockMesh(Block &block)
+void ChunkMeshBuilder::generateBlockMesh(const glm::ivec3 &pos, BlockType type)
 {
     // ================NEIGHBOR CACHING===================================
-    Block *cache[27];
+    NeighborCache cache;
     for (int i = 0; i < 27; i++)
     {
         glm::ivec3 offset = glm::ivec3(i % 3 - 1, (i / 3) % 3 - 1, i / 9 - 1);
-        cache[i] = getNeighborBlock(block.position, offset);
+        cache[i] = getNeighborBlock(pos, offset);
     }
-
-    // Helper to get neighbor from cache
-    auto getNeighborPtrFromCache = [&](int x, int y, int z) -> Block *
-    {
-        // Convert offset from [-1, 1] to [0, 2] for array indexing
-        return cache[(x + 1) + (y + 1) * 3 + (z + 1) * 9];
-    };
     // ========================================================================
 
     for (int f = 0; f < 6; f++)
     {
         const auto offset = BlockFaceData::FACE_OFFSETS[f];
-        Block *neighborBlockPtr = getNeighborPtrFromCache(offset.x, offset.y, offset.z);
+        const NeighborBlock &neighbor = cache[getCacheIndex(offset.x, offset.y, offset.z)];
 
-        // If the neighbor adjacent the curr block face is transparent or is missing, generate the mesh for the face
-        if (!neighborBlockPtr || isTransparent(neighborBlockPtr->type))
+        // If the neighbor adjacent the curr block face is transparent or is missing, generate the mesh for the face.
+        // Touching blocks of the same transparent type (glass panes, leaves) share no face
+        if (!neighbor.opaque && neighbor.type != type)
         {
-            uint8_t nLight = neighborBlockPtr ? neighborBlockPtr->skylight : 0;
-            generateFaceMesh(block, nLight, static_cast<BlockFaces>(f), getNeighborPtrFromCache);
+            generateFaceMesh(pos, type, neighbor, static_cast<BlockFaces>(f), cache);
         }
     }
 }
 
-void ChunkMeshBuilder::generateFaceMesh(Block &block, uint8_t adjacentBlockSkylight, BlockFaces face, const std::function<Block *(int, int, int)> &getNeighborPtrFromCache)
+void ChunkMeshBuilder::generateFaceMesh(const glm::ivec3 &pos, BlockType type, const NeighborBlock &adjacentBlock, BlockFaces face, const NeighborCache &cache)
 {
-    // std::cout << "Light value for block: " << static_cast<float>(block.skylight) / 15.0f << std::endl;
-    const auto &faceUVs = textureAtlas_.getBlockFaceUVs(block.type, face);
-    const auto &corners = BlockFaceData::faceCorners.at(face);
-    const auto &aoData = BlockFaceData::aoOffsets.at(face);
+    const auto &faceUVs = textureAtlas_.getBlockFaceUVs(type, face);
+    const auto &corners = BlockFaceData::faceCorners[static_cast<int>(face)];
+    const auto &aoData = BlockFaceData::aoOffsets[static_cast<int>(face)];
 
     // ao helper function
     auto computeAO = [&](const std::array<glm::ivec3, 3> &offsets)
     {
-        Block *n0 = getNeighborPtrFromCache(offsets[0].x, offsets[0].y, offsets[0].z);
-        Block *n1 = getNeighborPtrFromCache(offsets[1].x, offsets[1].y, offsets[1].z);
-        Block *n2 = getNeighborPtrFromCache(offsets[2].x, offsets[2].y, offsets[2].z);
+        const NeighborBlock &n0 = cache[getCacheIndex(offsets[0].x, offsets[0].y, offsets[0].z)];
+        const NeighborBlock &n1 = cache[getCacheIndex(offsets[1].x, offsets[1].y, offsets[1].z)];
+        const NeighborBlock &n2 = cache[getCacheIndex(offsets[2].x, offsets[2].y, offsets[2].z)];
 
-        bool side1 = (n0 && !isTransparent(n0->type));
-        bool side2 = (n1 && !isTransparent(n1->type));
-        bool corner = (n2 && !isTransparent(n2->type));
+        bool side1 = n0.opaque;
+        bool side2 = n1.opaque;
+        bool corner = n2.opaque;
 
         if (side1 && side2)
             return 0.3f; // Darkest
@@ -100,17 +95,18 @@ void ChunkMeshBuilder::generateFaceMesh(Block &block, uint8_t adjacentBlockSkyli
         return 1.0f - occlusion * 0.2f; // Simple mapping: 1.0, 0.8, 0.6, 0.4
     };
 
-    // Calculate Skylight for Face
+    // A face is lit by the block in front of it, both channels share one float, see Vertex
+    const float light = static_cast<float>(adjacentBlock.skylight + adjacentBlock.blocklight * 16);
+
     unsigned int baseVertexIndex = static_cast<unsigned int>(meshData_.vertices_.size());
     // Make vertex for each corner of face
     for (int i = 0; i < 4; i++)
     {
         Vertex v;
-        v.position = corners[i] + glm::vec3(block.position);
+        v.position = corners[i] + glm::vec3(pos);
         v.textureCoords = faceUVs[i];
         v.ao = computeAO(aoData[i]);
-        // Skylight = 0-15, so normalize to [0 - 1] for OpenGL
-        v.light = static_cast<float>(adjacentBlockSkylight) / 15.0f;
+        v.light = light;
         meshData_.vertices_.push_back(v);
     }
 
@@ -120,7 +116,7 @@ void ChunkMeshBuilder::generateFaceMesh(Block &block, uint8_t adjacentBlockSkyli
     }
 }
 
-Block *ChunkMeshBuilder::getNeighborBlock(const glm::ivec3 blockPos, const glm::ivec3 offset)
+NeighborBlock ChunkMeshBuilder::getNeighborBlock(const glm::ivec3 blockPos, const glm::ivec3 offset)
 {
     const auto northChunk = neighborChunks_[0];
     const auto southChunk = neighborChunks_[1];
@@ -129,10 +125,16 @@ Block *ChunkMeshBuilder::getNeighborBlock(const glm::ivec3 blockPos, const glm::
 
     const glm::ivec3 neighborLocalPos = blockPos + offset;
 
+    // Reads the block from whichever chunk holds it
+    auto sample = [](const Chunk &chunk, const glm::ivec3 &localPos)
+    {
+        return NeighborBlock{chunk.getBlockType(localPos), chunk.isOpaque(localPos), chunk.getSkylight(localPos), chunk.getBlocklight(localPos)};
+    };
+
     // if it's in the chunk, just get it
     if (Chunk::blockPosInChunkBounds(neighborLocalPos))
     {
-        return chunk_->getBlockLocal(neighborLocalPos);
+        return sample(*chunk_, neighborLocalPos);
     }
     else
     {
@@ -144,7 +146,7 @@ Block *ChunkMeshBuilder::getNeighborBlock(const glm::ivec3 blockPos, const glm::
             if (westChunk)
             {
                 glm::ivec3 localPosInNeighbor = {neighborLocalPos.x + Constants::CHUNK_SIZE_X, neighborLocalPos.y, neighborLocalPos.z};
-                return westChunk->getBlockLocal(localPosInNeighbor);
+                return sample(*westChunk, localPosInNeighbor);
             }
         }
         // Check East neighbor (+X direction)
@@ -155,7 +157,7 @@ Block *ChunkMeshBuilder::getNeighborBlock(const glm::ivec3 blockPos, const glm::
             if (eastChunk)
             {
                 glm::ivec3 localPosInNeighbor = {neighborLocalPos.x - Constants::CHUNK_SIZE_X, neighborLocalPos.y, neighborLocalPos.z};
-                return eastChunk->getBlockLocal(localPosInNeighbor);
+                return sample(*eastChunk, localPosInNeighbor);
             }
         }
         // Check South neighbor (-Z direction)
@@ -166,7 +168,7 @@ Block *ChunkMeshBuilder::getNeighborBlock(const glm::ivec3 blockPos, const glm::
             if (southChunk)
             {
                 glm::ivec3 localPosInNeighbor = {neighborLocalPos.x, neighborLocalPos.y, neighborLocalPos.z + Constants::CHUNK_SIZE_Z};
-                return southChunk->getBlockLocal(localPosInNeighbor);
+                return sample(*southChunk, localPosInNeighbor);
             }
         }
         // Check North neighbor (+Z direction)
@@ -177,37 +179,53 @@ Block *ChunkMeshBuilder::getNeighborBlock(const glm::ivec3 blockPos, const glm::
             if (northChunk)
             {
                 glm::ivec3 localPosInNeighbor = {neighborLocalPos.x, neighborLocalPos.y, neighborLocalPos.z - Constants::CHUNK_SIZE_Z};
-                return northChunk->getBlockLocal(localPosInNeighbor);
+                return sample(*northChunk, localPosInNeighbor);
             }
         }
 
         // block not found
-        return nullptr;
+        return NeighborBlock{};
     }
 }
 
 bool ChunkMeshBuilder::isBlockHiddenByNeighbors(const glm::ivec3 &pos)
 {
-    // Quick check if all 6 neighbors are solid blocks
-    for (const auto &offset : BlockFaceData::FACE_OFFSETS)
+    using namespace Constants;
+
+    // Edge blocks are never completely hidden
+    if (pos.x == 0 || pos.x == CHUNK_SIZE_X - 1 ||
+        pos.y == 0 || pos.y == CHUNK_SIZE_Y - 1 ||
+        pos.z == 0 || pos.z == CHUNK_SIZE_Z - 1)
+        return false;
+
+    // Hidden if all 6 neighbors are opaque: both x neighbors come from the block's own row,
+    // the other four from the same bit of the rows around it
+    const uint16_t bit = 1 << pos.x;
+    const uint16_t xNeighbors = (1 << (pos.x - 1)) | (1 << (pos.x + 1));
+    return (chunk_->getOpaqueRow(pos.y, pos.z) & xNeighbors) == xNeighbors &&
+           (chunk_->getOpaqueRow(pos.y + 1, pos.z) &
+            chunk_->getOpaqueRow(pos.y - 1, pos.z) &
+            chunk_->getOpaqueRow(pos.y, pos.z + 1) &
+            chunk_->getOpaqueRow(pos.y, pos.z - 1) & bit) != 0;
+}
+
+bool ChunkMeshBuilder::isSectionHidden(int sectionIndex) const
+{
+    if (!chunk_->isSectionUniformSolid(sectionIndex))
+        return false;
+
+    // The top and bottom of the world count as exposed
+    if (sectionIndex == 0 || sectionIndex == Constants::SECTIONS_PER_CHUNK - 1)
+        return false;
+    if (!chunk_->isSectionUniformSolid(sectionIndex - 1) || !chunk_->isSectionUniformSolid(sectionIndex + 1))
+        return false;
+
+    // Missing neighbor chunks count as exposed too
+    for (const auto &neighbor : neighborChunks_)
     {
-        glm::ivec3 neighborPos = pos + offset;
-        if (Chunk::blockPosInChunkBounds(neighborPos))
-        {
-            if (isTransparent(chunk_->getBlockLocal(neighborPos)->type))
-            {
-                return false;
-            }
-        }
-        else
-        {
-            return false; // Edge blocks are never completely hidden
-        }
+        if (!neighbor || !neighbor->isSectionUniformSolid(sectionIndex))
+            return false;
     }
+
     return true;
 }
-
-inline bool ChunkMeshBuilder::isTransparent(BlockType type) const
-{
-    return type == BlockType::Air;
-}
\ No newline at end of file
@@ -2,19 +2,38 @@
 #include "Chunk/ChunkManager.h"
 #include "Chunk/ChunkMeshBuilder.h"
 #include "Chunk/Chunk.h"
+#include "FeatureGenerator.h"
 #include "LightSystem.h"
+#include "Constants.h"
 
 #include "Performance/ScopedTimer.h"
+#include "Performance/Profiler.h"
 
+#include <algorithm>
+#include <array>
+#include <thread>
 #include <vector>
 #include <iostream>
 
-ChunkPipeline::ChunkPipeline() {}
+namespace
+{
+    // Leave a core for the main thread
+    size_t getWorkerCount()
+    {
+        const unsigned int cores = std::thread::hardware_concurrency();
+        return cores > 1 ? cores - 1 : 1;
+    }
+}
 
-void ChunkPipeline::init(ChunkManager *chunkManager, LightSystem *lightSystem)
+ChunkPipeline::ChunkPipeline() : workerPool_(getWorkerCount()) {}
+
+void ChunkPipeline::init(ChunkManager *chunkManager, LightSystem *lightSystem, const TerrainGenerator *terrainGenerator,
+                         const FeatureGenerator *featureGenerator)
 {
     chunkManager_ = chunkManager;
     lightSystem_ = lightSystem;
+    terrainGenerator_ = terrainGenerator;
+    featureGenerator_ = featureGenerator;
 }
 
 void ChunkPipeline::generateTerrain(std::shared_ptr<Chunk> chunk)
@@ -22,8 +41,16 @@ void ChunkPipeline::generateTerrain(std::shared_ptr<Chunk> chunk)
     if (!chunk)
         return;
 
-    chunk->generateTerrain();
-    chunkManager_->notifyStateChange({chunk, ChunkState::TERRAIN_GENERATED});
+    // The task's copy of the chunk keeps it alive if it's unloaded meanwhile, its event is dropped then
+    tasksInFlight_++;
+    workerPool_.enqueue([this, chunk]()
+                        {
+                            chunk->generateTerrain(*terrainGenerator_);
+                            featureGenerator_->placeFeatures(*chunk, pendingWrites_);
+                            // Whatever neighbors generated earlier left for it, anything later is applied on the main thread
+                            pendingWrites_.applyTo(*chunk);
+                            completeTask({chunk, ChunkState::TERRAIN_GENERATED});
+                        });
 }
 
 void ChunkPipeline::seedInitialLight(std::shared_ptr<Chunk> chunk)
@@ -31,8 +58,12 @@ void ChunkPipeline::seedInitialLight(std::shared_ptr<Chunk> chunk)
     if (!chunk)
         return;
 
-    lightSystem_->seedInitialSkylight(chunk);
-    chunkManager_->notifyStateChange({chunk, ChunkState::INITIAL_LIGHT_READY});
+    tasksInFlight_++;
+    workerPool_.enqueue([this, chunk]()
+                        {
+                            seedLight(chunk);
+                            completeTask({chunk, ChunkState::INITIAL_LIGHT_READY});
+                        });
 }
 
 void ChunkPipeline::propogateLight(std::shared_ptr<Chunk> chunk)
@@ -40,7 +71,13 @@ void ChunkPipeline::propogateLight(std::shared_ptr<Chunk> chunk)
     if (!chunk)
         return;
 
-    lightSystem_->updateBorderLighting(chunk);
+    // Light can flow out of the chunk too, only the neighbors it actually reached get remeshed
+    const LightSystem::LightUpdate update = lightSystem_->updateBorderLighting(getLightWindow(chunk->getCoord()));
+    for (const auto &changedChunk : update.changedChunks)
+    {
+        if (changedChunk != chunk)
+            chunkManager_->notifyStateChange({changedChunk, ChunkState::NEEDS_MESH_REGEN});
+    }
     chunkManager_->notifyStateChange({chunk, ChunkState::FINAL_LIGHT_READY});
 }
 
@@ -49,14 +86,41 @@ void ChunkPipeline::generateMesh(std::shared_ptr<Chunk> chunk)
     if (!chunk)
         return;
 
-    MeshData emptyMeshData;
+    ChunkPool &pool = chunkManager_->getChunkPool();
     auto neighbors = chunkManager_->getChunkNeighbors(chunk->getCoord());
+    // Neighbors before their initial light may still be on a worker, mesh as if they weren't loaded
+    for (auto &neighbor : neighbors)
+    {
+        if (neighbor && neighbor->getState() < ChunkState::INITIAL_LIGHT_READY)
+            neighbor.reset();
+    }
     const TextureAtlas &atlas = chunkManager_->getTextureAtlasRef();
 
-    ChunkMeshBuilder builder(emptyMeshData, atlas, chunk, neighbors);
-    MeshData &newMeshData = builder.buildMesh();
+    // Only rebuild the sections that changed since they were last meshed
+    const uint16_t dirtySections = chunk->getDirtySections();
+    for (int i = 0; i < Constants::SECTIONS_PER_CHUNK; i++)
+    {
+        if (!(dirtySections & (1 << i)))
+            continue;
+        chunk->clearSectionDirty(i);
+
+        MeshData scratchMeshData = pool.acquireMeshData();
+        ChunkMeshBuilder builder(scratchMeshData, atlas, chunk, neighbors);
+        builder.buildSectionMesh(i);
+
+        // Nothing left to draw, drop whatever the section showed before
+        if (scratchMeshData.indices_.empty())
+        {
+            if (ChunkMesh *mesh = chunk->getSectionMesh(i))
+                mesh->reset();
+            pool.releaseMeshData(std::move(scratchMeshData));
+            continue;
+        }
+
+        // The scratch buffers travel with the section until they're uploaded
+        chunk->setSectionMeshData(i, std::move(scratchMeshData));
+    }
 
-    chunk->setMeshData(newMeshData);
     chunkManager_->notifyStateChange({chunk, ChunkState::MESH_READY});
 }
 
@@ -65,6 +129,185 @@ void ChunkPipeline::uploadMeshToGPU(std::shared_ptr<Chunk> chunk)
     if (!chunk)
         return;
 
-    chunk->getMesh().uploadMesh();
+    ChunkPool &pool = chunkManager_->getChunkPool();
+    for (int i = 0; i < Constants::SECTIONS_PER_CHUNK; i++)
+    {
+        ChunkMesh *mesh = chunk->getSectionMesh(i);
+        if (!mesh || !mesh->hasPendingUpload())
+            continue;
+
+        mesh->uploadMesh();
+        mesh->setMeshValid();
+        // The GPU has its own copy now, the CPU buffers go back to the pool
+        pool.releaseMeshData(mesh->takeMeshData());
+    }
     chunkManager_->notifyStateChange({chunk, ChunkState::LOADED});
-}
\ No newline at end of file
+}
+
+void ChunkPipeline::processCompletedTasks()
+{
+    std::vector<StateChangeEvent> completed;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex_);
+        completed.swap(completedTasks_);
+    }
+
+    for (auto &event : completed)
+        chunkManager_->notifyStateChange(std::move(event));
+
+    Profiler::get().recordValue("Pipeline tasks in flight", tasksInFlight_.load());
+}
+
+void ChunkPipeline::applyLateFeatureWrites()
+{
+    for (const auto &coord : pendingWrites_.takeWrittenTargets())
+        lateWriteTargets_.insert(coord);
+
+    for (auto it = lateWriteTargets_.begin(); it != lateWriteTargets_.end();)
+    {
+        auto chunk = chunkManager_->getChunk(*it);
+        // Not loaded, its terrain task takes everything stored for it once it is
+        if (!chunk)
+        {
+            it = lateWriteTargets_.erase(it);
+            continue;
+        }
+
+        // Still in the pipeline, wait until nothing else is working on its blocks
+        if (chunk->getState() != ChunkState::LOADED)
+        {
+            ++it;
+            continue;
+        }
+
+        if (pendingWrites_.applyTo(*chunk))
+            chunkManager_->notifyStateChange({chunk, ChunkState::NEEDS_LIGHT_UPDATE});
+        it = lateWriteTargets_.erase(it);
+    }
+
+    Profiler::get().recordValue("Pending feature blocks", pendingWrites_.getBlockCount());
+}
+
+void ChunkPipeline::materializeSection(std::shared_ptr<Chunk> chunk, int sectionIndex)
+{
+    if (!chunk || chunk->getState() != ChunkState::LOADED)
+        return;
+    if (!chunk->materializeSection(sectionIndex, *terrainGenerator_))
+        return;
+
+    // Neighbor blocks next to new caves get faces now
+    for (const auto &neighbor : chunkManager_->getChunkNeighbors(chunk->getCoord()))
+    {
+        if (neighbor)
+            neighbor->markSectionDirty(sectionIndex);
+    }
+    chunkManager_->notifyStateChange({chunk, ChunkState::NEEDS_LIGHT_UPDATE});
+}
+
+void ChunkPipeline::onBlockChanged(std::shared_ptr<Chunk> chunk, const glm::ivec3 &localPos)
+{
+    using namespace Constants;
+
+    if (!chunk || chunk->getState() != ChunkState::LOADED)
+        return;
+
+    const LightSystem::Neighborhood window = getLightWindow(chunk->getCoord());
+    std::vector<std::shared_ptr<Chunk>> changed = lightSystem_->updateBlockLight(window, localPos).changedChunks;
+    changed.push_back(chunk);
+
+    // The block's faces show or hide against the neighbor chunk's blocks it touches
+    auto markNeighbor = [&](int index, const glm::ivec3 &neighborPos)
+    {
+        if (!window[index])
+            return;
+        window[index]->markBlockDirty(neighborPos);
+        changed.push_back(window[index]);
+    };
+    if (localPos.x == 0)
+        markNeighbor(3, {CHUNK_SIZE_X - 1, localPos.y, localPos.z});
+    if (localPos.x == CHUNK_SIZE_X - 1)
+        markNeighbor(5, {0, localPos.y, localPos.z});
+    if (localPos.z == 0)
+        markNeighbor(1, {localPos.x, localPos.y, CHUNK_SIZE_Z - 1});
+    if (localPos.z == CHUNK_SIZE_Z - 1)
+        markNeighbor(7, {localPos.x, localPos.y, 0});
+
+    for (auto &changedChunk : changed)
+        chunkManager_->notifyStateChange({std::move(changedChunk), ChunkState::NEEDS_MESH_REGEN});
+}
+
+void ChunkPipeline::onChunkRemoved(const ChunkCoord &coord)
+{
+    pendingWrites_.removeSource(coord);
+    lateWriteTargets_.erase(coord);
+}
+
+void ChunkPipeline::seedLight(std::shared_ptr<Chunk> chunk)
+{
+    lightSystem_->seedInitialSkylight(chunk);
+
+    // Sky light reaching a placeholder section means a cave opens into it from the surface,
+    // generate it so the cave doesn't end on a fake floor
+    for (int i = chunk->findLitPlaceholderSection(); i >= 0; i = chunk->findLitPlaceholderSection())
+    {
+        chunk->materializeSection(i, *terrainGenerator_);
+        chunk->clearSkylight();
+        lightSystem_->seedInitialSkylight(chunk);
+    }
+
+    lightSystem_->seedInitialBlocklight(chunk);
+}
+
+void ChunkPipeline::relight(std::shared_ptr<Chunk> chunk)
+{
+    if (!chunk || chunk->getState() != ChunkState::LOADED)
+        return;
+
+    // Light that flowed out of the chunk is still in its neighbors, and their border light would
+    // carry it straight back in. It can't have spread past them, so the 3x3 chunks around it
+    // are all lit again from scratch
+    const LightSystem::Neighborhood window = getLightWindow(chunk->getCoord());
+    for (const auto &windowChunk : window)
+    {
+        if (!windowChunk)
+            continue;
+        windowChunk->clearSkylight();
+        windowChunk->clearBlocklight();
+        windowChunk->markAllSectionsDirty();
+        seedLight(windowChunk);
+    }
+
+    // Neighbors take light back in from the chunks around them and keep their meshes,
+    // the middle chunk goes through final light and meshing again
+    for (const auto &windowChunk : window)
+    {
+        if (!windowChunk || windowChunk == chunk)
+            continue;
+        lightSystem_->updateBorderLighting(getLightWindow(windowChunk->getCoord()));
+        chunkManager_->notifyStateChange({windowChunk, ChunkState::NEEDS_MESH_REGEN});
+    }
+    propogateLight(chunk);
+}
+
+LightSystem::Neighborhood ChunkPipeline::getLightWindow(const ChunkCoord &coord) const
+{
+    // Chunks before their initial light may still be on a worker
+    LightSystem::Neighborhood window;
+    for (int dz = -1; dz <= 1; dz++)
+    {
+        for (int dx = -1; dx <= 1; dx++)
+        {
+            auto neighbor = chunkManager_->getChunk({coord.x + dx, coord.z + dz});
+            if (neighbor && neighbor->getState() >= ChunkState::INITIAL_LIGHT_READY)
+                window[(dz + 1) * 3 + dx + 1] = std::move(neighbor);
+        }
+    }
+    return window;
+}
+
+void ChunkPipeline::completeTask(StateChangeEvent event)
+{
+    std::lock_guard<std::mutex> lock(completedMutex_);
+    completedTasks_.push_back(std::move(event));
+    tasksInFlight_--;
+}
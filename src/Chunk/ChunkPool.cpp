@@ -0,0 +1,74 @@
+#include "Chunk/ChunkPool.h"
+#include "Chunk/Chunk.h"
+#include "Performance/Profiler.h"
+
+ChunkPool::ChunkPool(Shader *chunkShader, size_t maxChunks, size_t maxMeshData)
+    : chunkShader_(chunkShader), maxChunks_(maxChunks), maxMeshData_(maxMeshData)
+{
+}
+
+std::shared_ptr<Chunk> ChunkPool::acquire(const ChunkCoord &coord)
+{
+    std::shared_ptr<Chunk> chunk;
+    if (!freeChunks_.empty())
+    {
+        chunk = std::move(freeChunks_.back());
+        freeChunks_.pop_back();
+        retainedBytes_ -= chunk->getMemoryUsage();
+        chunk->reset(coord);
+        hits_++;
+    }
+    else
+    {
+        chunk = std::make_shared<Chunk>(chunkShader_, coord);
+        misses_++;
+    }
+
+    return chunk;
+}
+
+void ChunkPool::release(std::shared_ptr<Chunk> chunk)
+{
+    // Pipeline batches or queued events may still reference the chunk, let it die with them
+    if (!chunk || chunk.use_count() > 1 || freeChunks_.size() >= maxChunks_)
+        return;
+
+    // Pooled chunks aren't touched, so their size stays what it was here until they're acquired
+    retainedBytes_ += chunk->getMemoryUsage();
+    freeChunks_.push_back(std::move(chunk));
+}
+
+MeshData ChunkPool::acquireMeshData()
+{
+    if (freeMeshData_.empty())
+        return MeshData();
+
+    MeshData meshData = std::move(freeMeshData_.back());
+    freeMeshData_.pop_back();
+    retainedBytes_ -= getCapacityBytes(meshData);
+    return meshData;
+}
+
+void ChunkPool::releaseMeshData(MeshData &&meshData)
+{
+    // Past the limit the buffers are simply freed
+    if (freeMeshData_.size() >= maxMeshData_)
+        return;
+
+    meshData.vertices_.clear();
+    meshData.indices_.clear();
+    retainedBytes_ += getCapacityBytes(meshData);
+    freeMeshData_.push_back(std::move(meshData));
+}
+
+size_t ChunkPool::getCapacityBytes(const MeshData &meshData)
+{
+    return meshData.vertices_.capacity() * sizeof(Vertex) + meshData.indices_.capacity() * sizeof(unsigned int);
+}
+
+void ChunkPool::reportStats() const
+{
+    const size_t requests = hits_ + misses_;
+    Profiler::get().recordValue("ChunkPool hit rate (%)", requests ? 100.0 * hits_ / requests : 0.0);
+    Profiler::get().recordValue("ChunkPool retained (MB)", retainedBytes_ / (1024.0 * 1024.0));
+}
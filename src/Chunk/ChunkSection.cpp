@@ -0,0 +1,168 @@
+#include "Chunk/ChunkSection.h"
+#include "Block/BlockRegistry.h"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+    // One per worker thread, unpacked palette indices while a section is repacked so repacking doesn't allocate
+    std::array<uint32_t, ChunkSection::VOLUME> &getThreadPaletteIndices()
+    {
+        thread_local std::array<uint32_t, ChunkSection::VOLUME> paletteIndices;
+        return paletteIndices;
+    }
+}
+
+ChunkSection::ChunkSection()
+    : palette_{BlockType::Air}, bitsPerEntry_(0), skylight_(VOLUME), blocklight_(VOLUME)
+{
+}
+
+void ChunkSection::setBlock(int index, BlockType type)
+{
+    if (isUniform() && palette_[0] == type)
+        return;
+
+    const int paletteIndex = getOrAddPaletteIndex(type);
+    setPaletteIndex(index, paletteIndex);
+}
+
+void ChunkSection::fill(BlockType type)
+{
+    palette_.assign(1, static_cast<uint16_t>(type));
+    bitsPerEntry_ = 0;
+    data_.clear();
+}
+
+void ChunkSection::reset()
+{
+    palette_.assign(1, static_cast<uint16_t>(BlockType::Air));
+    bitsPerEntry_ = 0;
+    data_.clear();
+    skylight_.reset(0);
+    blocklight_.reset(0);
+}
+
+void ChunkSection::compact()
+{
+    if (isUniform())
+        return;
+
+    auto &paletteIndices = getThreadPaletteIndices();
+    std::vector<int> remap(palette_.size(), -1);
+    std::vector<uint16_t> newPalette;
+
+    const uint64_t mask = (uint64_t(1) << bitsPerEntry_) - 1;
+    for (int i = 0; i < VOLUME; i++)
+    {
+        const int bitIndex = i * bitsPerEntry_;
+        const uint32_t oldIndex = static_cast<uint32_t>((data_[bitIndex >> 6] >> (bitIndex & 63)) & mask);
+        if (remap[oldIndex] < 0)
+        {
+            remap[oldIndex] = static_cast<int>(newPalette.size());
+            newPalette.push_back(palette_[oldIndex]);
+        }
+        paletteIndices[i] = remap[oldIndex];
+    }
+
+    if (newPalette.size() == 1)
+    {
+        fill(static_cast<BlockType>(newPalette[0]));
+        return;
+    }
+
+    int newBitsPerEntry = 1;
+    while ((size_t(1) << newBitsPerEntry) < newPalette.size())
+        newBitsPerEntry *= 2;
+
+    palette_ = std::move(newPalette);
+    bitsPerEntry_ = newBitsPerEntry;
+    data_.assign(VOLUME * bitsPerEntry_ / 64, 0);
+
+    for (int i = 0; i < VOLUME; i++)
+        setPaletteIndex(i, paletteIndices[i]);
+}
+
+void ChunkSection::fillSkylight(uint8_t level)
+{
+    skylight_.fill(level);
+}
+
+void ChunkSection::fillBlocklight(uint8_t level)
+{
+    blocklight_.fill(level);
+}
+
+bool ChunkSection::hasEmitters() const
+{
+    return std::any_of(palette_.begin(), palette_.end(), [](uint16_t type)
+                       { return BlockRegistry::getEmission(static_cast<BlockType>(type)) > 0; });
+}
+
+bool ChunkSection::hasAttenuators() const
+{
+    return std::any_of(palette_.begin(), palette_.end(), [](uint16_t type)
+                       {
+                           const BlockType blockType = static_cast<BlockType>(type);
+                           return !BlockRegistry::isOpaque(blockType) && BlockRegistry::getLightAttenuation(blockType) > 0;
+                       });
+}
+
+size_t ChunkSection::getPaletteSize() const
+{
+    return palette_.size();
+}
+
+size_t ChunkSection::getMemoryUsage() const
+{
+    return sizeof(ChunkSection) +
+           palette_.capacity() * sizeof(uint16_t) +
+           data_.capacity() * sizeof(uint64_t) +
+           skylight_.getMemoryUsage() +
+           blocklight_.getMemoryUsage();
+}
+
+int ChunkSection::getOrAddPaletteIndex(BlockType type)
+{
+    // Palettes are tiny (a handful of block types), a linear scan beats a map here
+    for (size_t i = 0; i < palette_.size(); i++)
+    {
+        if (palette_[i] == type)
+            return static_cast<int>(i);
+    }
+
+    palette_.push_back(static_cast<uint16_t>(type));
+    const int paletteIndex = static_cast<int>(palette_.size() - 1);
+
+    // Widen the packed indices once the palette no longer fits
+    if (palette_.size() > (size_t(1) << bitsPerEntry_))
+        resize(bitsPerEntry_ == 0 ? 1 : bitsPerEntry_ * 2);
+
+    return paletteIndex;
+}
+
+void ChunkSection::resize(int newBitsPerEntry)
+{
+    // A uniform section is all palette index 0
+    auto &paletteIndices = getThreadPaletteIndices();
+    if (isUniform())
+    {
+        paletteIndices.fill(0);
+    }
+    else
+    {
+        const uint64_t mask = (uint64_t(1) << bitsPerEntry_) - 1;
+        for (int i = 0; i < VOLUME; i++)
+        {
+            const int bitIndex = i * bitsPerEntry_;
+            paletteIndices[i] = static_cast<uint32_t>((data_[bitIndex >> 6] >> (bitIndex & 63)) & mask);
+        }
+    }
+
+    bitsPerEntry_ = std::min(newBitsPerEntry, 16);
+    data_.assign(VOLUME * bitsPerEntry_ / 64, 0);
+
+    for (int i = 0; i < VOLUME; i++)
+        setPaletteIndex(i, paletteIndices[i]);
+}
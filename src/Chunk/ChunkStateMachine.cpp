@@ -51,6 +51,11 @@ void ChunkStateMachine::setState(ChunkState newState)
     currentState_.store(newState);
 }
 
+void ChunkStateMachine::reset()
+{
+    currentState_.store(ChunkState::EMPTY);
+}
+
 ChunkState ChunkStateMachine::getState() const
 {
     return currentState_.load();
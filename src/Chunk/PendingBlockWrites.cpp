@@ -0,0 +1,89 @@
+#include "Chunk/PendingBlockWrites.h"
+#include "Chunk/Chunk.h"
+
+#include <algorithm>
+
+void PendingBlockWrites::setWrites(const ChunkCoord &source, const ChunkCoord &target, std::vector<FeatureBlock> blocks)
+{
+    {
+        Shard &shard = getShard(target);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto &sources = shard.targets[target];
+
+        auto it = std::find_if(sources.begin(), sources.end(), [&](const SourceWrites &writes)
+                               { return writes.source == source; });
+        if (it != sources.end())
+        {
+            blockCount_ -= it->blocks.size();
+            blockCount_ += blocks.size();
+            it->blocks = std::move(blocks);
+        }
+        else
+        {
+            blockCount_ += blocks.size();
+            sources.push_back({source, std::move(blocks)});
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(writtenMutex_);
+    writtenTargets_.push_back(target);
+}
+
+std::vector<FeatureBlock> PendingBlockWrites::getWrites(const ChunkCoord &target)
+{
+    Shard &shard = getShard(target);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    std::vector<FeatureBlock> blocks;
+    auto it = shard.targets.find(target);
+    if (it == shard.targets.end())
+        return blocks;
+
+    for (const auto &writes : it->second)
+        blocks.insert(blocks.end(), writes.blocks.begin(), writes.blocks.end());
+    return blocks;
+}
+
+bool PendingBlockWrites::applyTo(Chunk &chunk)
+{
+    bool changed = false;
+    for (const auto &block : getWrites(chunk.getCoord()))
+        changed |= FeatureGenerator::applyBlock(chunk, block.pos, block.type);
+    return changed;
+}
+
+void PendingBlockWrites::removeSource(const ChunkCoord &source)
+{
+    // Features reach at most one chunk over, see FeatureGenerator::MAX_RADIUS
+    for (int dz = -1; dz <= 1; dz++)
+    {
+        for (int dx = -1; dx <= 1; dx++)
+        {
+            const ChunkCoord target = {source.x + dx, source.z + dz};
+            Shard &shard = getShard(target);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            auto it = shard.targets.find(target);
+            if (it == shard.targets.end())
+                continue;
+
+            auto &sources = it->second;
+            auto removed = std::remove_if(sources.begin(), sources.end(), [&](const SourceWrites &writes)
+                                          { return writes.source == source; });
+            for (auto writes = removed; writes != sources.end(); ++writes)
+                blockCount_ -= writes->blocks.size();
+            sources.erase(removed, sources.end());
+
+            if (sources.empty())
+                shard.targets.erase(it);
+        }
+    }
+}
+
+std::vector<ChunkCoord> PendingBlockWrites::takeWrittenTargets()
+{
+    std::vector<ChunkCoord> targets;
+    std::lock_guard<std::mutex> lock(writtenMutex_);
+    targets.swap(writtenTargets_);
+    return targets;
+}
@@ -0,0 +1,178 @@
+#include "FeatureGenerator.h"
+#include "TerrainGenerator.h"
+#include "Chunk/Chunk.h"
+#include "Chunk/PendingBlockWrites.h"
+#include "Biome.h"
+
+#include <array>
+
+namespace
+{
+    constexpr uint32_t TREE_SALT = 0x7F4A7C15u;
+    constexpr uint32_t BOULDER_SALT = 0x2545F491u;
+
+    // Tallest tree is its trunk plus a layer of leaves above it
+    constexpr int MAX_TREE_HEIGHT = 7;
+
+    // Low 24 bits of a hash as a roll in [0, 1)
+    inline float toChance(uint32_t hash)
+    {
+        return (hash & 0xFFFFFFu) / 16777216.0f;
+    }
+}
+
+FeatureGenerator::FeatureGenerator(const TerrainGenerator &terrainGenerator, int seed)
+    : terrainGenerator_(terrainGenerator), seed_(static_cast<uint32_t>(seed))
+{
+}
+
+void FeatureGenerator::generateFeatures(const Chunk &chunk, std::vector<FeatureBlock> &out) const
+{
+    using namespace Constants;
+
+    const int chunkWorldX = chunk.getCoord().x * CHUNK_SIZE_X;
+    const int chunkWorldZ = chunk.getCoord().z * CHUNK_SIZE_Z;
+
+    // Same tiles the terrain was just generated from, so this is a cache hit
+    std::array<TerrainColumn, CHUNK_SIZE_X * CHUNK_SIZE_Z> columns;
+    terrainGenerator_.getColumnGrid(chunkWorldX, chunkWorldZ, CHUNK_SIZE_X, CHUNK_SIZE_Z, columns.data());
+
+    for (int z = 0; z < CHUNK_SIZE_Z; z++)
+    {
+        for (int x = 0; x < CHUNK_SIZE_X; x++)
+        {
+            const TerrainColumn &column = columns[x + z * CHUNK_SIZE_X];
+            const int height = column.height;
+            if (height < 0 || height + MAX_TREE_HEIGHT >= CHUNK_SIZE_Y)
+                continue;
+
+            // Caves can eat the surface block, nothing grows on those columns
+            const BlockType surface = chunk.getBlockType({x, height, z});
+            if (surface != column.surfaceBlock)
+                continue;
+
+            const BiomeProperties &biome = Biomes::get(column.biome);
+            const int worldX = chunkWorldX + x;
+            const int worldZ = chunkWorldZ + z;
+
+            const uint32_t treeHash = hashColumn(worldX, worldZ, TREE_SALT);
+            if (surface == BlockType::Grass && toChance(treeHash) < biome.treeChance)
+            {
+                placeTree({x, height + 1, z}, treeHash, out);
+                continue;
+            }
+
+            const uint32_t boulderHash = hashColumn(worldX, worldZ, BOULDER_SALT);
+            if (toChance(boulderHash) < biome.boulderChance)
+                placeBoulder({x, height, z}, boulderHash, out);
+        }
+    }
+}
+
+void FeatureGenerator::placeFeatures(Chunk &chunk, PendingBlockWrites &pendingWrites) const
+{
+    using namespace Constants;
+
+    std::vector<FeatureBlock> blocks;
+    generateFeatures(chunk, blocks);
+
+    std::array<std::vector<FeatureBlock>, 9> spills;
+    for (const auto &block : blocks)
+    {
+        const int dx = block.pos.x < 0 ? -1 : (block.pos.x >= CHUNK_SIZE_X ? 1 : 0);
+        const int dz = block.pos.z < 0 ? -1 : (block.pos.z >= CHUNK_SIZE_Z ? 1 : 0);
+        if (dx == 0 && dz == 0)
+        {
+            applyBlock(chunk, block.pos, block.type);
+            continue;
+        }
+
+        const glm::ivec3 targetPos = block.pos - glm::ivec3(dx * CHUNK_SIZE_X, 0, dz * CHUNK_SIZE_Z);
+        spills[(dx + 1) + (dz + 1) * 3].push_back({targetPos, block.type});
+    }
+
+    const ChunkCoord coord = chunk.getCoord();
+    for (int i = 0; i < 9; i++)
+    {
+        if (!spills[i].empty())
+            pendingWrites.setWrites(coord, {coord.x + i % 3 - 1, coord.z + i / 3 - 1}, std::move(spills[i]));
+    }
+}
+
+bool FeatureGenerator::applyBlock(Chunk &chunk, const glm::ivec3 &pos, BlockType type)
+{
+    if (pos.y < 0 || pos.y >= Constants::CHUNK_SIZE_Y)
+        return false;
+
+    const BlockType current = chunk.getBlockType(pos);
+    if (current != BlockType::Air && (getPriority(current) == 0 || getPriority(type) <= getPriority(current)))
+        return false;
+
+    chunk.setBlockAt(pos, type);
+    return true;
+}
+
+uint32_t FeatureGenerator::hashColumn(int worldX, int worldZ, uint32_t salt) const
+{
+    // Murmur3 finalizer over the mixed inputs
+    uint32_t h = seed_ ^ salt;
+    h ^= static_cast<uint32_t>(worldX) * 0x85EBCA6Bu;
+    h = (h << 13) | (h >> 19);
+    h ^= static_cast<uint32_t>(worldZ) * 0xC2B2AE35u;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+void FeatureGenerator::placeTree(const glm::ivec3 &base, uint32_t hash, std::vector<FeatureBlock> &out) const
+{
+    const int trunkHeight = 4 + static_cast<int>((hash >> 24) % 3);
+    const int top = base.y + trunkHeight - 1;
+
+    // Two wide layers around the top of the trunk, then a narrow one and a plus on top.
+    // The wide layers' corners are dropped at random so the trees don't all look the same
+    for (int dy = -2; dy <= 1; dy++)
+    {
+        const int radius = dy < 0 ? MAX_RADIUS : 1;
+        for (int dz = -radius; dz <= radius; dz++)
+        {
+            for (int dx = -radius; dx <= radius; dx++)
+            {
+                const bool corner = (dx == -radius || dx == radius) && (dz == -radius || dz == radius);
+                if (corner)
+                {
+                    if (radius == 1 && dy == 1)
+                        continue;
+                    const int cornerBit = ((dx > 0) ? 1 : 0) + ((dz > 0) ? 2 : 0) + (dy + 2) * 4;
+                    if (radius == MAX_RADIUS && (hash >> cornerBit) & 1)
+                        continue;
+                }
+                out.push_back({{base.x + dx, top + dy, base.z + dz}, BlockType::Leaves});
+            }
+        }
+    }
+
+    for (int y = base.y; y <= top; y++)
+        out.push_back({{base.x, y, base.z}, BlockType::Log});
+}
+
+void FeatureGenerator::placeBoulder(const glm::ivec3 &center, uint32_t hash, std::vector<FeatureBlock> &out) const
+{
+    // Centered on the surface so it sits half buried, only the air around it gets filled
+    const int radius = 1 + static_cast<int>((hash >> 24) & 1);
+    const int radiusSq = radius * radius + radius;
+    for (int dy = -radius; dy <= radius; dy++)
+    {
+        for (int dz = -radius; dz <= radius; dz++)
+        {
+            for (int dx = -radius; dx <= radius; dx++)
+            {
+                if (dx * dx + dy * dy + dz * dz <= radiusSq)
+                    out.push_back({{center.x + dx, center.y + dy, center.z + dz}, BlockType::Cobblestone});
+            }
+        }
+    }
+}
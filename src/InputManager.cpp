@@ -72,6 +72,18 @@ void InputManager::key_callback(GLFWwindow *window, int key, int scancode, int a
         case GLFW_KEY_7:
             inputManager->world_.setPlayerBlockType(BlockType::Brick);
             break;
+        case GLFW_KEY_8:
+            inputManager->world_.setPlayerBlockType(BlockType::Glass);
+            break;
+        case GLFW_KEY_9:
+            inputManager->world_.setPlayerBlockType(BlockType::Leaves);
+            break;
+        case GLFW_KEY_0:
+            inputManager->world_.setPlayerBlockType(BlockType::Sand);
+            break;
+        case GLFW_KEY_T:
+            inputManager->world_.setPlayerBlockType(BlockType::Torch);
+            break;
         }
     }
 }
@@ -1,284 +1,597 @@
 #include "LightSystem.h"
-#include "World.h"
 #include "Chunk/Chunk.h"
 #include "Chunk/ChunkCoord.h"
-#include "Block/Block.h"
 #include "Constants.h"
 #include "Performance/ScopedTimer.h"
+#include "Performance/Profiler.h"
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
 #include <memory>
-#include <iostream>
-#include <queue>
 #include <array>
+#include <utility>
+#include <vector>
 
-LightSystem::LightSystem(World *world, ChunkManager *manager) : world_(world), chunkManager_(manager)
+namespace
 {
+    // One per worker thread, reused by every call so propagation doesn't allocate
+    LightQueue &getThreadLightQueue()
+    {
+        thread_local LightQueue queue;
+        queue.clear();
+        return queue;
+    }
+
+    // Second queue for the darkness pass of block updates
+    LightQueue &getThreadRemovalQueue()
+    {
+        thread_local LightQueue queue;
+        queue.clear();
+        return queue;
+    }
+
+    // A 16x16 layer as one bit per block, bit x of row z
+    using LayerRows = std::array<uint16_t, Constants::CHUNK_SIZE_Z>;
+    static_assert(Constants::CHUNK_SIZE_X == 16, "Layer rows are 16 bit masks");
+    constexpr uint16_t FULL_LAYER_ROW = 0xFFFF;
+
+    // Sky light of a layer, a mask per level with the blocks that have at least that level.
+    // Level 0 is unused and the one past the brightest stays empty, so blocks at exactly
+    // level k are levels[k] & ~levels[k + 1]
+    using LayerLight = std::array<LayerRows, LightSystem::MAX_LIGHT_LEVEL + 2>;
+
+    // Blocks next to a set bit of the mask in row z, sideways within the layer
+    inline uint16_t spreadSideways(const LayerRows &mask, int z)
+    {
+        uint32_t spread = (mask[z] << 1) | (mask[z] >> 1);
+        if (z > 0)
+            spread |= mask[z - 1];
+        if (z < Constants::CHUNK_SIZE_Z - 1)
+            spread |= mask[z + 1];
+        return static_cast<uint16_t>(spread);
+    }
 }
 
-void LightSystem::updateBorderLighting(std::shared_ptr<Chunk> chunk)
+// The 3x3 chunks around one, addressed with positions relative to the window's corner so
+// BFS nodes can cross chunk borders. Missing chunks act as opaque walls
+class LightSystem::ChunkWindow
 {
-    using namespace Constants;
+public:
+    static constexpr int SIZE_X = 3 * Constants::CHUNK_SIZE_X;
+    static constexpr int SIZE_Z = 3 * Constants::CHUNK_SIZE_Z;
 
-    std::queue<LightNode> lightQueue;
-    seedFromNeighborChunks(chunk, lightQueue);
+    explicit ChunkWindow(const Neighborhood &chunks) : chunks_(chunks) {}
 
-    while (!lightQueue.empty())
+    // Window position of a block in the middle chunk
+    static inline glm::ivec3 fromCenter(const glm::ivec3 &localPos)
+    {
+        return localPos + glm::ivec3(Constants::CHUNK_SIZE_X, 0, Constants::CHUNK_SIZE_Z);
+    }
+
+    // x in bits 0-5, z in 6-11, y in 12-19, light in 20-23
+    static inline uint32_t pack(const glm::ivec3 &pos, int light)
+    {
+        return static_cast<uint32_t>(pos.x | (pos.z << 6) | (pos.y << 12) | (light << 20));
+    }
+    static inline glm::ivec3 getPos(uint32_t node)
+    {
+        return glm::ivec3(static_cast<int>(node & 0x3F), static_cast<int>((node >> 12) & 0xFF), static_cast<int>((node >> 6) & 0x3F));
+    }
+    static inline int getLight(uint32_t node) { return static_cast<int>((node >> 20) & 0xF); }
+
+    inline bool contains(const glm::ivec3 &pos) const
+    {
+        return pos.x >= 0 && pos.x < SIZE_X && pos.y >= 0 && pos.y < Constants::CHUNK_SIZE_Y &&
+               pos.z >= 0 && pos.z < SIZE_Z && getChunk(pos);
+    }
+
+    // Chunk holding a position and the position inside it, null outside the window.
+    // Lets the BFS look a block up once instead of once per accessor
+    inline Chunk *find(const glm::ivec3 &pos, glm::ivec3 &localPos) const
+    {
+        if (!contains(pos))
+            return nullptr;
+        localPos = toLocal(pos);
+        return getChunk(pos);
+    }
+
+    inline uint8_t getLight(LightChannel channel, const glm::ivec3 &pos) const { return getChunk(pos)->getLight(channel, toLocal(pos)); }
+    inline bool isOpaque(const glm::ivec3 &pos) const { return getChunk(pos)->isOpaque(toLocal(pos)); }
+    inline BlockType getBlockType(const glm::ivec3 &pos) const { return getChunk(pos)->getBlockType(toLocal(pos)); }
+
+    void setLight(LightChannel channel, const glm::ivec3 &pos, uint8_t level)
     {
-        LightNode currNode = lightQueue.front();
-        lightQueue.pop();
+        const int index = getChunkIndex(pos);
+        const glm::ivec3 localPos = toLocal(pos);
+        chunks_[index]->setLight(channel, localPos, level);
+        changedChunks_ |= static_cast<uint16_t>(1 << index);
+
+        // Faces across the border are lit by this block too
+        if (localPos.x == 0)
+            markAcrossBorder(pos + glm::ivec3(-1, 0, 0));
+        else if (localPos.x == Constants::CHUNK_SIZE_X - 1)
+            markAcrossBorder(pos + glm::ivec3(1, 0, 0));
+        if (localPos.z == 0)
+            markAcrossBorder(pos + glm::ivec3(0, 0, -1));
+        else if (localPos.z == Constants::CHUNK_SIZE_Z - 1)
+            markAcrossBorder(pos + glm::ivec3(0, 0, 1));
+    }
 
-        // skip if chunk doesn't exist
-        if (!currNode.chunk)
+    std::vector<std::shared_ptr<Chunk>> getChangedChunks() const
+    {
+        std::vector<std::shared_ptr<Chunk>> changed;
+        for (int i = 0; i < 9; i++)
         {
-            std::cout << "CHUNK DOESN'T EXIST" << std::endl;
-            continue;
+            if ((changedChunks_ >> i) & 1)
+                changed.push_back(chunks_[i]);
         }
+        return changed;
+    }
 
-        Block &currBlock = *currNode.chunk->getBlockLocal(currNode.localPos);
-        for (const auto &dir : directions)
-        {
-            LightNode nNode{currNode.chunk, currNode.localPos + dir};
+private:
+    const Neighborhood &chunks_;
+    uint16_t changedChunks_ = 0;
 
-            // If neighbor position isn't in chunk bounds skip
-            if (!Chunk::blockPosInChunkBounds(nNode.localPos))
-                continue;
+    static inline int getChunkIndex(const glm::ivec3 &pos)
+    {
+        return (pos.z / Constants::CHUNK_SIZE_Z) * 3 + pos.x / Constants::CHUNK_SIZE_X;
+    }
+    static inline glm::ivec3 toLocal(const glm::ivec3 &pos)
+    {
+        return {pos.x % Constants::CHUNK_SIZE_X, pos.y, pos.z % Constants::CHUNK_SIZE_Z};
+    }
+    inline Chunk *getChunk(const glm::ivec3 &pos) const { return chunks_[getChunkIndex(pos)].get(); }
 
-            Block *nBlockPtr = nNode.chunk->getBlockLocal(nNode.localPos);
+    void markAcrossBorder(const glm::ivec3 &outside)
+    {
+        if (!contains(outside))
+            return;
 
-            if (!isTransparent(nBlockPtr->type))
-                continue;
+        const int index = getChunkIndex(outside);
+        chunks_[index]->markBlockDirty(toLocal(outside));
+        changedChunks_ |= static_cast<uint16_t>(1 << index);
+    }
+};
 
-            int potential_new_light;
-            // Light doesn't dim downwards
-            if (dir.y == -1)
-            {
-                potential_new_light = currBlock.skylight;
-            }
-            // Regular for all other directions
-            else
-            {
-                potential_new_light = currBlock.skylight - 1;
-            }
+LightSystem::LightUpdate LightSystem::updateBorderLighting(const Neighborhood &chunks)
+{
+    ScopedTimer timer("LightSystem::updateBorderLighting");
 
-            if (potential_new_light > nBlockPtr->skylight)
-            {
-                nBlockPtr->skylight = static_cast<uint8_t>(potential_new_light);
-                lightQueue.push(nNode);
-            }
-        }
+    ChunkWindow window(chunks);
+    LightUpdate update;
+    for (const LightChannel channel : {LightChannel::Sky, LightChannel::Block})
+    {
+        LightQueue &lightQueue = getThreadLightQueue();
+        seedAcrossBorders(window, channel, lightQueue);
+        propagateWindowLight(window, lightQueue, channel);
+        update.nodes += lightQueue.getPopCount();
     }
+
+    update.changedChunks = window.getChangedChunks();
+    return update;
 }
 
-void LightSystem::seedInitialSkylight(std::shared_ptr<Chunk> chunk)
+size_t LightSystem::seedInitialSkylight(std::shared_ptr<Chunk> chunk)
 {
     using namespace Constants;
+    ScopedTimer timer("LightSystem::seedInitialSkylight");
+
+    // 1. Sections of pure air above the highest non-air section are open sky, light them in O(1)
+    int skyStartSection = SECTIONS_PER_CHUNK;
+    while (skyStartSection > 0)
+    {
+        const ChunkSection &section = chunk->getSection(skyStartSection - 1);
+        if (!section.isUniform() || section.getUniformBlock() != BlockType::Air)
+            break;
+        skyStartSection--;
+    }
 
-    std::queue<LightNode> lightQueue;
-    auto &blocks = chunk->getBlocks();
+    for (int i = skyStartSection; i < SECTIONS_PER_CHUNK; i++)
+        chunk->getSection(i).fillSkylight(MAX_LIGHT_LEVEL);
 
-    // 1. Set all air blocks in column to light level 15 and push to queue until the first solid block is reached
+    // 2. Light the rest of the chunk from there
+    if (skylightEngine_ == SkylightEngine::Bitwise)
+        return propagateSkylightBitwise(*chunk, skyStartSection);
+    return propagateSkylightBfs(*chunk, skyStartSection);
+}
+
+size_t LightSystem::propagateSkylightBfs(Chunk &chunk, int skyStartSection)
+{
+    using namespace Constants;
+
+    LightQueue &lightQueue = getThreadLightQueue();
+
+    // Everything above a column's highest block sees the sky, straight from the heightmap. Of the
+    // fully lit sections only the bottom layer can light anything, so only it gets queued
+    const int scanStartY = std::min(skyStartSection * SECTION_SIZE, CHUNK_SIZE_Y - 1);
     for (int x = 0; x < CHUNK_SIZE_X; x++)
     {
         for (int z = 0; z < CHUNK_SIZE_Z; z++)
         {
-            for (int y = CHUNK_SIZE_Y - 1; y >= 0; y--)
+            const int columnHeight = chunk.getHeight(x, z);
+            for (int y = scanStartY; y > columnHeight; y--)
             {
-                int index = Chunk::getBlockIndex({x, y, z});
-                Block &block = blocks[index];
-
-                if (!isTransparent(block.type))
-                    break;
+                chunk.setSkylight({x, y, z}, MAX_LIGHT_LEVEL);
+                lightQueue.push(LightQueue::pack(x, y, z, MAX_LIGHT_LEVEL));
+            }
 
-                block.skylight = 15;
-                lightQueue.push({chunk, {x, y, z}});
+            // A see-through block at the top of the world is lit straight from the sky above it
+            const glm::ivec3 topPos(x, CHUNK_SIZE_Y - 1, z);
+            if (columnHeight == topPos.y && !chunk.isOpaque(topPos))
+            {
+                const int level = MAX_LIGHT_LEVEL - BlockRegistry::getLightAttenuation(chunk.getBlockType(topPos));
+                if (level > 0)
+                {
+                    chunk.setSkylight(topPos, static_cast<uint8_t>(level));
+                    lightQueue.push(LightQueue::pack(x, topPos.y, z, level));
+                }
             }
         }
     }
 
-    // 2. Progate the light within current chunk only
-    while (!lightQueue.empty())
-    {
-        LightNode currNode = lightQueue.front();
-        lightQueue.pop();
-
-        if (!currNode.chunk)
-        {
-            std::cout << "CHUNK DOESN'T EXIST" << std::endl;
-            continue;
-        }
+    // Progate the light within current chunk only, never upwards
+    propagateLight(chunk, lightQueue, LightChannel::Sky, false);
+    return lightQueue.getPopCount();
+}
 
-        Block &currBlock = *currNode.chunk->getBlockLocal(currNode.localPos);
-        for (const auto &dir : directions)
-        {
-            // Don't go up on initial skylight
-            if (dir.y == 1)
-                continue;
+size_t LightSystem::propagateSkylightBitwise(Chunk &chunk, int skyStartSection)
+{
+    using namespace Constants;
 
-            glm::ivec3 nPos = currNode.localPos + dir;
+    // Sky light never goes up, so a layer's light only depends on the layer above it. Sweeping
+    // down, a layer first takes the light falling into it, then each level spreads one block
+    // sideways into the level below it. Brightest levels go first, so the masks a level is
+    // spread from are already final
+    LayerLight above;
+    LayerLight layer;
+    for (int level = 1; level <= MAX_LIGHT_LEVEL; level++)
+        above[level].fill(FULL_LAYER_ROW);
+    above[MAX_LIGHT_LEVEL + 1].fill(0);
+    layer[MAX_LIGHT_LEVEL + 1].fill(0);
+
+    // See-through blocks by how much they dim light, most layers only have undimmed ones
+    std::array<LayerRows, MAX_LIGHT_LEVEL> passable;
+    bool sectionAttenuates = false;
+
+    size_t litBlocks = 0;
+    for (int y = skyStartSection * SECTION_SIZE - 1; y >= 0; y--)
+    {
+        const int localY = y % SECTION_SIZE;
+        ChunkSection &section = chunk.getSection(y / SECTION_SIZE);
+        if (localY == SECTION_SIZE - 1)
+            sectionAttenuates = section.hasAttenuators();
 
-            // If local position isn't in chunk bounds, skip
-            if (!Chunk::blockPosInChunkBounds(nPos))
-                continue;
+        // Bit a is set when the layer has blocks in passable[a]
+        uint16_t attenuations = 1;
+        for (int z = 0; z < CHUNK_SIZE_Z; z++)
+            passable[0][z] = static_cast<uint16_t>(~chunk.getOpaqueRow(y, z));
 
-            Block *nBlockPtr = chunk->getBlockLocal(nPos);
+        if (sectionAttenuates)
+        {
+            for (int a = 1; a < MAX_LIGHT_LEVEL; a++)
+                passable[a].fill(0);
 
-            if (!isTransparent(nBlockPtr->type))
-                continue;
+            for (int z = 0; z < CHUNK_SIZE_Z; z++)
+            {
+                for (int x = 0; x < CHUNK_SIZE_X; x++)
+                {
+                    const uint16_t bit = static_cast<uint16_t>(1 << x);
+                    if (!(passable[0][z] & bit))
+                        continue;
+
+                    const int a = BlockRegistry::getLightAttenuation(section.getBlock(ChunkSection::getBlockIndex({x, localY, z})));
+                    if (a == 0)
+                        continue;
+
+                    // Blocks dimming it all the way are never lit
+                    passable[0][z] &= static_cast<uint16_t>(~bit);
+                    if (a < MAX_LIGHT_LEVEL)
+                    {
+                        passable[a][z] |= bit;
+                        attenuations |= static_cast<uint16_t>(1 << a);
+                    }
+                }
+            }
+        }
 
-            int potential_new_light;
-            // Light doesn't dim downwards
-            if (dir.y == -1)
+        // Falling light keeps its level, less what the block dims it by
+        for (int level = 1; level <= MAX_LIGHT_LEVEL; level++)
+        {
+            for (int z = 0; z < CHUNK_SIZE_Z; z++)
             {
-                potential_new_light = currBlock.skylight;
+                uint16_t lit = 0;
+                for (int a = 0; level + a <= MAX_LIGHT_LEVEL; a++)
+                {
+                    if ((attenuations >> a) & 1)
+                        lit |= above[level + a][z] & passable[a][z];
+                }
+                layer[level][z] = lit;
             }
-            // Regular for all other directions
-            else
+        }
+
+        // Sideways it loses a level on top of that
+        for (int level = MAX_LIGHT_LEVEL - 1; level >= 1; level--)
+        {
+            for (int z = 0; z < CHUNK_SIZE_Z; z++)
             {
-                potential_new_light = currBlock.skylight - 1;
+                uint16_t lit = layer[level][z] | layer[level + 1][z];
+                for (int a = 0; level + 1 + a <= MAX_LIGHT_LEVEL; a++)
+                {
+                    if ((attenuations >> a) & 1)
+                        lit |= spreadSideways(layer[level + 1 + a], z) & passable[a][z];
+                }
+                layer[level][z] = lit;
             }
+        }
+
+        // Nothing reached this layer, so nothing reaches any layer below it either
+        uint16_t anyLit = 0;
+        for (int z = 0; z < CHUNK_SIZE_Z; z++)
+            anyLit |= layer[1][z];
+        if (!anyLit)
+            break;
 
-            if (potential_new_light > nBlockPtr->skylight)
+        for (int level = 1; level <= MAX_LIGHT_LEVEL; level++)
+        {
+            for (int z = 0; z < CHUNK_SIZE_Z; z++)
             {
-                nBlockPtr->skylight = static_cast<uint8_t>(potential_new_light);
-                lightQueue.push({chunk, nPos});
+                // Blocks at exactly this level
+                uint16_t exact = layer[level][z] & static_cast<uint16_t>(~layer[level + 1][z]);
+                for (int x = 0; exact; x++, exact >>= 1)
+                {
+                    if (!(exact & 1))
+                        continue;
+                    section.setSkylight(ChunkSection::getBlockIndex({x, localY, z}), static_cast<uint8_t>(level));
+                    litBlocks++;
+                }
             }
         }
+        chunk.markBlockDirty({0, y, 0});
+
+        std::swap(above, layer);
     }
+
+    return litBlocks;
 }
 
-void LightSystem::seedFromNeighborChunks(std::shared_ptr<Chunk> chunk, std::queue<LightNode> &lightQueue)
+size_t LightSystem::seedInitialBlocklight(std::shared_ptr<Chunk> chunk)
 {
     using namespace Constants;
+    ScopedTimer timer("LightSystem::seedInitialBlocklight");
 
-    auto neighbors = chunkManager_->getChunkNeighbors(chunk->getCoord());
-    auto westChunk = neighbors[3];
-    auto eastChunk = neighbors[2];
-    auto southChunk = neighbors[1];
-    auto northChunk = neighbors[0];
+    LightQueue &lightQueue = getThreadLightQueue();
 
-    auto &currBlocks = chunk->getBlocks();
+    // Emissive blocks are rare, only sections with one in their palette get looked through
+    for (int i = 0; i < SECTIONS_PER_CHUNK; i++)
+    {
+        const ChunkSection &section = chunk->getSection(i);
+        if (!section.hasEmitters())
+            continue;
 
-    if (westChunk)
+        for (int index = 0; index < ChunkSection::VOLUME; index++)
+        {
+            const uint8_t emission = BlockRegistry::getEmission(section.getBlock(index));
+            if (emission == 0)
+                continue;
+
+            const glm::ivec3 pos = ChunkSection::getBlockPosition(index) + glm::ivec3(0, i * SECTION_SIZE, 0);
+            chunk->setBlocklight(pos, emission);
+            lightQueue.push(LightQueue::pack(pos.x, pos.y, pos.z, emission));
+        }
+    }
+
+    propagateLight(*chunk, lightQueue, LightChannel::Block, true);
+    return lightQueue.getPopCount();
+}
+
+LightSystem::LightUpdate LightSystem::updateBlockLight(const Neighborhood &chunks, const glm::ivec3 &localPos)
+{
+    using namespace Constants;
+    ScopedTimer timer("LightSystem::updateBlockLight");
+
+    ChunkWindow window(chunks);
+    LightQueue &removalQueue = getThreadRemovalQueue();
+    LightQueue &lightQueue = getThreadLightQueue();
+    const glm::ivec3 editPos = ChunkWindow::fromCenter(localPos);
+    // Blocks that light themselves: emissive ones, or the top of the world for sky light
+    std::vector<glm::ivec3> emitters;
+
+    size_t nodes = 0;
+    for (const LightChannel channel : {LightChannel::Sky, LightChannel::Block})
     {
-        auto &westBlocks = westChunk->getBlocks();
+        removalQueue.clear();
+        lightQueue.clear();
 
-        for (int y = 0; y < CHUNK_SIZE_Y; y++)
+        // 1. Take the light off the edited block, the darkness pass finds everything it was lighting
+        const uint8_t oldLight = window.getLight(channel, editPos);
+        if (oldLight > 0)
         {
-            for (int z = 0; z < CHUNK_SIZE_Z; z++)
-            {
-                int currI = Chunk::getBlockIndex({0, y, z});
-                int nI = Chunk::getBlockIndex({CHUNK_SIZE_X - 1, y, z});
+            window.setLight(channel, editPos, 0);
+            removalQueue.push(ChunkWindow::pack(editPos, oldLight));
+        }
 
-                Block &currBlock = currBlocks[currI];
-                Block &nBlock = westBlocks[nI];
+        // 2. A neighbor that could have gotten its light from a darkened block goes dark too.
+        // Brighter ones are lit from somewhere else and become sources to fill the dark area back in.
+        // Emissive blocks that went dark light themselves again afterwards
+        emitters.clear();
+        while (!removalQueue.empty())
+        {
+            const uint32_t node = removalQueue.pop();
+            const int removedLight = ChunkWindow::getLight(node);
+            const glm::ivec3 currPos = ChunkWindow::getPos(node);
+
+            for (const auto &dir : directions)
+            {
+                const glm::ivec3 nPos = currPos + dir;
+                if (!window.contains(nPos))
+                    continue;
 
-                if (nBlock.skylight <= 0)
+                const uint8_t nLight = window.getLight(channel, nPos);
+                if (nLight == 0)
                     continue;
 
-                uint8_t potential_new_level = nBlock.skylight - 1;
-                if (isTransparent(currBlock.type) &&
-                    potential_new_level > currBlock.skylight &&
-                    potential_new_level > 0)
+                const BlockType nType = window.getBlockType(nPos);
+                if (nLight <= getPropagatedLight(removedLight, dir, nType, channel))
+                {
+                    window.setLight(channel, nPos, 0);
+                    removalQueue.push(ChunkWindow::pack(nPos, nLight));
+                    if (channel == LightChannel::Block && BlockRegistry::getEmission(nType) > 0)
+                        emitters.push_back(nPos);
+                }
+                else
                 {
-                    currBlock.skylight = potential_new_level;
-                    lightQueue.push({chunk, {0, y, z}});
+                    lightQueue.push(ChunkWindow::pack(nPos, nLight));
                 }
             }
         }
-    }
-
-    if (eastChunk)
-    {
-        auto &eastBlocks = eastChunk->getBlocks();
 
-        for (int y = 0; y < CHUNK_SIZE_Y; y++)
+        // 3. The edited block lets light through now, its neighbors spread into it.
+        // At the top of the world it's open to the sky, and it may give off light itself
+        if (!window.isOpaque(editPos))
         {
-            for (int z = 0; z < CHUNK_SIZE_Z; z++)
-            {
-                int currI = Chunk::getBlockIndex({CHUNK_SIZE_X - 1, y, z});
-                int nI = Chunk::getBlockIndex({0, y, z});
+            if (channel == LightChannel::Sky && editPos.y == CHUNK_SIZE_Y - 1)
+                emitters.push_back(editPos);
 
-                Block &currBlock = currBlocks[currI];
-                Block &nBlock = eastBlocks[nI];
-
-                if (nBlock.skylight <= 0)
+            for (const auto &dir : directions)
+            {
+                const glm::ivec3 nPos = editPos + dir;
+                if (!window.contains(nPos))
                     continue;
 
-                uint8_t potential_new_level = nBlock.skylight - 1;
-                if (isTransparent(currBlock.type) &&
-                    potential_new_level > currBlock.skylight &&
-                    potential_new_level > 0)
-                {
-                    currBlock.skylight = potential_new_level;
-                    lightQueue.push({chunk, {CHUNK_SIZE_X - 1, y, z}});
-                }
+                const uint8_t nLight = window.getLight(channel, nPos);
+                if (nLight > 0)
+                    lightQueue.push(ChunkWindow::pack(nPos, nLight));
             }
         }
+        if (channel == LightChannel::Block && BlockRegistry::getEmission(window.getBlockType(editPos)) > 0)
+            emitters.push_back(editPos);
+
+        for (const auto &pos : emitters)
+        {
+            const uint8_t level = channel == LightChannel::Sky ? MAX_LIGHT_LEVEL : BlockRegistry::getEmission(window.getBlockType(pos));
+            if (level <= window.getLight(channel, pos))
+                continue;
+            window.setLight(channel, pos, level);
+            lightQueue.push(ChunkWindow::pack(pos, level));
+        }
+
+        // 4. Same propagation as within a chunk, but across the window
+        propagateWindowLight(window, lightQueue, channel);
+
+        nodes += removalQueue.getPopCount() + lightQueue.getPopCount();
     }
 
-    if (southChunk)
+    Profiler::get().recordValue("Light nodes per block update", nodes);
+    return {nodes, window.getChangedChunks()};
+}
+
+void LightSystem::propagateLight(Chunk &chunk, LightQueue &lightQueue, LightChannel channel, bool spreadUp)
+{
+    while (!lightQueue.empty())
     {
-        auto &southBlocks = southChunk->getBlocks();
+        const uint32_t node = lightQueue.pop();
+        const int currLight = LightQueue::getLight(node);
+        const glm::ivec3 currPos = LightQueue::getPos(node);
 
-        for (int y = 0; y < CHUNK_SIZE_Y; y++)
+        // Raised again after it was queued, the newer node spreads the brighter light
+        if (chunk.getLight(channel, currPos) != currLight)
+            continue;
+
+        for (const auto &dir : directions)
         {
-            for (int x = 0; x < CHUNK_SIZE_X; x++)
-            {
-                int currI = Chunk::getBlockIndex({x, y, 0});
-                int nI = Chunk::getBlockIndex({x, y, CHUNK_SIZE_Z - 1});
+            if (dir.y == 1 && !spreadUp)
+                continue;
 
-                Block &currBlock = currBlocks[currI];
-                Block &nBlock = southBlocks[nI];
+            const glm::ivec3 nPos = currPos + dir;
 
-                if (nBlock.skylight <= 0)
-                    continue;
+            // If local position isn't in chunk bounds, skip
+            if (!Chunk::blockPosInChunkBounds(nPos))
+                continue;
 
-                uint8_t potential_new_level = nBlock.skylight - 1;
-                if (isTransparent(currBlock.type) &&
-                    potential_new_level > currBlock.skylight &&
-                    potential_new_level > 0)
-                {
-                    currBlock.skylight = potential_new_level;
-                    lightQueue.push({chunk, {x, y, 0}});
-                }
+            if (chunk.isOpaque(nPos))
+                continue;
+
+            const int potential_new_light = getPropagatedLight(currLight, dir, chunk.getBlockType(nPos), channel);
+
+            if (potential_new_light > chunk.getLight(channel, nPos))
+            {
+                chunk.setLight(channel, nPos, static_cast<uint8_t>(potential_new_light));
+                lightQueue.push(LightQueue::pack(nPos.x, nPos.y, nPos.z, potential_new_light));
             }
         }
     }
+}
+
+void LightSystem::seedAcrossBorders(ChunkWindow &window, LightChannel channel, LightQueue &lightQueue)
+{
+    using namespace Constants;
 
-    if (northChunk)
+    // Either side of each of the middle chunk's four borders may be brighter than the other can
+    // explain, the brighter block lights the one across from it. Light flows out as well as in
+    auto spreadAcross = [&](const glm::ivec3 &from, const glm::ivec3 &to, const glm::ivec3 &dir)
     {
-        auto &northBlocks = northChunk->getBlocks();
+        const uint8_t fromLight = window.getLight(channel, from);
+        if (fromLight <= 1 || window.isOpaque(to))
+            return;
 
+        const int potential_new_level = getPropagatedLight(fromLight, dir, window.getBlockType(to), channel);
+        if (potential_new_level > window.getLight(channel, to))
+        {
+            window.setLight(channel, to, static_cast<uint8_t>(potential_new_level));
+            lightQueue.push(ChunkWindow::pack(to, potential_new_level));
+        }
+    };
+
+    const glm::ivec3 origin = ChunkWindow::fromCenter({0, 0, 0});
+    for (const auto &dir : {glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1)})
+    {
+        // Blocks along the border inside the middle chunk
+        const int edgeX = dir.x > 0 ? CHUNK_SIZE_X - 1 : 0;
+        const int edgeZ = dir.z > 0 ? CHUNK_SIZE_Z - 1 : 0;
+        if (!window.contains(origin + glm::ivec3(edgeX, 0, edgeZ) + dir))
+            continue;
+
+        const int length = dir.x != 0 ? CHUNK_SIZE_Z : CHUNK_SIZE_X;
         for (int y = 0; y < CHUNK_SIZE_Y; y++)
         {
-            for (int x = 0; x < CHUNK_SIZE_X; x++)
+            for (int i = 0; i < length; i++)
             {
-                int currI = Chunk::getBlockIndex({x, y, CHUNK_SIZE_Z - 1});
-                int nI = Chunk::getBlockIndex({x, y, 0});
+                const glm::ivec3 inside = origin + (dir.x != 0 ? glm::ivec3(edgeX, y, i) : glm::ivec3(i, y, edgeZ));
+                const glm::ivec3 outside = inside + dir;
+                spreadAcross(outside, inside, -dir);
+                spreadAcross(inside, outside, dir);
+            }
+        }
+    }
+}
+
+void LightSystem::propagateWindowLight(ChunkWindow &window, LightQueue &lightQueue, LightChannel channel)
+{
+    while (!lightQueue.empty())
+    {
+        const uint32_t node = lightQueue.pop();
+        const int currLight = ChunkWindow::getLight(node);
+        const glm::ivec3 currPos = ChunkWindow::getPos(node);
 
-                Block &currBlock = currBlocks[currI];
-                Block &nBlock = northBlocks[nI];
+        // Raised again after it was queued, the newer node spreads the brighter light
+        if (window.getLight(channel, currPos) != currLight)
+            continue;
 
-                if (nBlock.skylight <= 0)
-                    continue;
+        for (const auto &dir : directions)
+        {
+            const glm::ivec3 nPos = currPos + dir;
+            glm::ivec3 localPos;
+            const Chunk *chunk = window.find(nPos, localPos);
+            if (!chunk || chunk->isOpaque(localPos))
+                continue;
 
-                uint8_t potential_new_level = nBlock.skylight - 1;
-                if (isTransparent(currBlock.type) &&
-                    potential_new_level > currBlock.skylight &&
-                    potential_new_level > 0)
-                {
-                    currBlock.skylight = potential_new_level;
-                    lightQueue.push({chunk, {x, y, CHUNK_SIZE_Z - 1}});
-                }
+            const int potential_new_light = getPropagatedLight(currLight, dir, chunk->getBlockType(localPos), channel);
+            if (potential_new_light > chunk->getLight(channel, localPos))
+            {
+                window.setLight(channel, nPos, static_cast<uint8_t>(potential_new_light));
+                lightQueue.push(ChunkWindow::pack(nPos, potential_new_light));
             }
         }
     }
 }
-
-void LightSystem::clearChunkLightLevels(std::shared_ptr<Chunk> chunk)
-{
-    for (auto &block : chunk->getBlocks())
-        block.skylight = 0;
-}
\ No newline at end of file
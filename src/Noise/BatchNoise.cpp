@@ -0,0 +1,500 @@
+#include "Noise/BatchNoise.h"
+
+#include <cstdint>
+
+// This file may be built with a wider instruction set than the rest of the game. Nothing outside
+// the BatchNoise functions may be shared with other files, even an inline or template function
+// like std::copy could be linked in from here and run on a CPU without that instruction set
+
+#if !defined(NOISE_SIMD_SCALAR) && defined(__AVX2__)
+#define NOISE_SIMD_AVX2
+#include <immintrin.h>
+#elif !defined(NOISE_SIMD_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NOISE_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // FastNoiseLite's gradient lookup tables, which it keeps private
+    alignas(32) const float GRADIENTS_2D[256] = {
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f,
+        0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f,
+        0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f,
+        0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f,
+        -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f,
+        -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f,
+        -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f,
+        0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f,
+        0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f,
+        0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f,
+        -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f,
+        -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f,
+        -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f,
+        0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f,
+        0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f,
+        0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f,
+        -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f,
+        -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f,
+        -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f,
+        0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f,
+        0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f,
+        0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f,
+        -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f,
+        -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f,
+        -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f,
+        0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f,
+        0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f,
+        0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f,
+        -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f,
+        -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f,
+        -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f,
+        0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+        -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f,
+        -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+    };
+
+    alignas(32) const float GRADIENTS_3D[256] = {
+        0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+        1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f,
+        1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+        1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f,
+        1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+        1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f,
+        1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+        1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f,
+        1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+        1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f,
+        1.0f, 1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f, 0.0f,
+        1.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+    };
+
+    constexpr int PRIME_X = 501125321;
+    constexpr int PRIME_Y = 1136930381;
+    constexpr int PRIME_Z = 1720413743;
+    constexpr int HASH_MULTIPLIER = 0x27d4eb2d;
+
+    // Lane policies, the kernels below are written once against this interface.
+    // F holds floats, I holds ints and M is a per lane mask from a comparison
+    struct ScalarLanes
+    {
+        static constexpr int WIDTH = 1;
+        using F = float;
+        using I = int32_t;
+        using M = bool;
+
+        static F load(const float *p) { return *p; }
+        static void store(float *p, F v) { *p = v; }
+        static F splat(float v) { return v; }
+        static I splatInt(int v) { return v; }
+
+        static F add(F a, F b) { return a + b; }
+        static F sub(F a, F b) { return a - b; }
+        static F mul(F a, F b) { return a * b; }
+
+        // Wrapping int math like the reference, done unsigned to stay defined behaviour
+        static I addInt(I a, I b) { return static_cast<I>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b)); }
+        static I subInt(I a, I b) { return static_cast<I>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b)); }
+        static I mulInt(I a, I b) { return static_cast<I>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b)); }
+        static I xorInt(I a, I b) { return a ^ b; }
+        static I orInt(I a, I b) { return a | b; }
+        static I andInt(I a, I b) { return a & b; }
+        static I shiftRight(I a, int bits) { return a >> bits; }
+
+        static I truncate(F v) { return static_cast<I>(v); }
+        static F toFloat(I v) { return static_cast<F>(v); }
+        static F gather(const float *table, I index) { return table[index]; }
+
+        static M greaterEqual(F a, F b) { return a >= b; }
+        static M greater(F a, F b) { return a > b; }
+        static M maskAnd(M a, M b) { return a && b; }
+        static M maskAndNot(M a, M b) { return !a && b; }
+        static M maskOr(M a, M b) { return a || b; }
+        static M maskNot(M a) { return !a; }
+        static F select(M m, F a, F b) { return m ? a : b; }
+        static I selectInt(M m, I a, I b) { return m ? a : b; }
+    };
+
+#if defined(NOISE_SIMD_AVX2)
+    struct Avx2Lanes
+    {
+        static constexpr int WIDTH = 8;
+        using F = __m256;
+        using I = __m256i;
+        using M = __m256;
+
+        static F load(const float *p) { return _mm256_loadu_ps(p); }
+        static void store(float *p, F v) { _mm256_storeu_ps(p, v); }
+        static F splat(float v) { return _mm256_set1_ps(v); }
+        static I splatInt(int v) { return _mm256_set1_epi32(v); }
+
+        static F add(F a, F b) { return _mm256_add_ps(a, b); }
+        static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+        static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+
+        static I addInt(I a, I b) { return _mm256_add_epi32(a, b); }
+        static I subInt(I a, I b) { return _mm256_sub_epi32(a, b); }
+        static I mulInt(I a, I b) { return _mm256_mullo_epi32(a, b); }
+        static I xorInt(I a, I b) { return _mm256_xor_si256(a, b); }
+        static I orInt(I a, I b) { return _mm256_or_si256(a, b); }
+        static I andInt(I a, I b) { return _mm256_and_si256(a, b); }
+        static I shiftRight(I a, int bits) { return _mm256_srai_epi32(a, bits); }
+
+        static I truncate(F v) { return _mm256_cvttps_epi32(v); }
+        static F toFloat(I v) { return _mm256_cvtepi32_ps(v); }
+        static F gather(const float *table, I index) { return _mm256_i32gather_ps(table, index, 4); }
+
+        static M greaterEqual(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+        static M greater(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static M maskAnd(M a, M b) { return _mm256_and_ps(a, b); }
+        static M maskAndNot(M a, M b) { return _mm256_andnot_ps(a, b); }
+        static M maskOr(M a, M b) { return _mm256_or_ps(a, b); }
+        static M maskNot(M a) { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+        static F select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+        static I selectInt(M m, I a, I b) { return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), m)); }
+    };
+    using Lanes = Avx2Lanes;
+    constexpr const char *KERNEL_NAME = "AVX2";
+#elif defined(NOISE_SIMD_SSE2)
+    struct Sse2Lanes
+    {
+        static constexpr int WIDTH = 4;
+        using F = __m128;
+        using I = __m128i;
+        using M = __m128;
+
+        static F load(const float *p) { return _mm_loadu_ps(p); }
+        static void store(float *p, F v) { _mm_storeu_ps(p, v); }
+        static F splat(float v) { return _mm_set1_ps(v); }
+        static I splatInt(int v) { return _mm_set1_epi32(v); }
+
+        static F add(F a, F b) { return _mm_add_ps(a, b); }
+        static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+        static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+
+        static I addInt(I a, I b) { return _mm_add_epi32(a, b); }
+        static I subInt(I a, I b) { return _mm_sub_epi32(a, b); }
+        // SSE2 has no 32 bit mullo, multiply even and odd lanes as 64 bit and keep the low halves
+        static I mulInt(I a, I b)
+        {
+            const __m128i even = _mm_mul_epu32(a, b);
+            const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        }
+        static I xorInt(I a, I b) { return _mm_xor_si128(a, b); }
+        static I orInt(I a, I b) { return _mm_or_si128(a, b); }
+        static I andInt(I a, I b) { return _mm_and_si128(a, b); }
+        static I shiftRight(I a, int bits) { return _mm_srai_epi32(a, bits); }
+
+        static I truncate(F v) { return _mm_cvttps_epi32(v); }
+        static F toFloat(I v) { return _mm_cvtepi32_ps(v); }
+        // No gather before AVX2, look the lanes up one at a time
+        static F gather(const float *table, I index)
+        {
+            alignas(16) int32_t lanes[4];
+            _mm_store_si128(reinterpret_cast<__m128i *>(lanes), index);
+            return _mm_setr_ps(table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]);
+        }
+
+        static M greaterEqual(F a, F b) { return _mm_cmpge_ps(a, b); }
+        static M greater(F a, F b) { return _mm_cmpgt_ps(a, b); }
+        static M maskAnd(M a, M b) { return _mm_and_ps(a, b); }
+        static M maskAndNot(M a, M b) { return _mm_andnot_ps(a, b); }
+        static M maskOr(M a, M b) { return _mm_or_ps(a, b); }
+        static M maskNot(M a) { return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+        static F select(M m, F a, F b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+        static I selectInt(M m, I a, I b) { return _mm_castps_si128(select(m, _mm_castsi128_ps(a), _mm_castsi128_ps(b))); }
+    };
+    using Lanes = Sse2Lanes;
+    constexpr const char *KERNEL_NAME = "SSE2";
+#else
+    using Lanes = ScalarLanes;
+    constexpr const char *KERNEL_NAME = "Scalar";
+#endif
+
+    // The kernels mirror FastNoiseLite's Single* functions step for step, with branches turned into selects
+
+    // FastNoiseLite's FastFloor, which rounds negative whole numbers down one further
+    template <typename L>
+    typename L::I fastFloor(typename L::F v)
+    {
+        const typename L::M negative = L::greater(L::splat(0.0f), v);
+        return L::subInt(L::truncate(v), L::selectInt(negative, L::splatInt(1), L::splatInt(0)));
+    }
+
+    template <typename L>
+    typename L::I fastRound(typename L::F v)
+    {
+        const typename L::M positive = L::greaterEqual(v, L::splat(0.0f));
+        return L::truncate(L::add(v, L::select(positive, L::splat(0.5f), L::splat(-0.5f))));
+    }
+
+    template <typename L>
+    typename L::F lerp(typename L::F a, typename L::F b, typename L::F t)
+    {
+        return L::add(a, L::mul(t, L::sub(b, a)));
+    }
+
+    template <typename L>
+    typename L::F interpQuintic(typename L::F t)
+    {
+        const typename L::F inner = L::add(L::mul(t, L::sub(L::mul(t, L::splat(6.0f)), L::splat(15.0f))), L::splat(10.0f));
+        return L::mul(L::mul(L::mul(t, t), t), inner);
+    }
+
+    template <typename L>
+    typename L::I hash(typename L::I seed, typename L::I xPrimed, typename L::I yPrimed)
+    {
+        const typename L::I h = L::mulInt(L::xorInt(L::xorInt(seed, xPrimed), yPrimed), L::splatInt(HASH_MULTIPLIER));
+        return L::xorInt(h, L::shiftRight(h, 15));
+    }
+
+    template <typename L>
+    typename L::F gradCoord(typename L::I seed, typename L::I xPrimed, typename L::I yPrimed, typename L::F xd, typename L::F yd)
+    {
+        const typename L::I index = L::andInt(hash<L>(seed, xPrimed, yPrimed), L::splatInt(127 << 1));
+        const typename L::F xg = L::gather(GRADIENTS_2D, index);
+        const typename L::F yg = L::gather(GRADIENTS_2D, L::orInt(index, L::splatInt(1)));
+        return L::add(L::mul(xd, xg), L::mul(yd, yg));
+    }
+
+    template <typename L>
+    typename L::F gradCoord(typename L::I seed, typename L::I xPrimed, typename L::I yPrimed, typename L::I zPrimed,
+                            typename L::F xd, typename L::F yd, typename L::F zd)
+    {
+        const typename L::I index = L::andInt(hash<L>(seed, L::xorInt(xPrimed, yPrimed), zPrimed), L::splatInt(63 << 2));
+        const typename L::F xg = L::gather(GRADIENTS_3D, index);
+        const typename L::F yg = L::gather(GRADIENTS_3D, L::orInt(index, L::splatInt(1)));
+        const typename L::F zg = L::gather(GRADIENTS_3D, L::orInt(index, L::splatInt(2)));
+        return L::add(L::add(L::mul(xd, xg), L::mul(yd, yg)), L::mul(zd, zg));
+    }
+
+    template <typename L>
+    typename L::F singlePerlin(typename L::I seed, typename L::F x, typename L::F y)
+    {
+        using F = typename L::F;
+        using I = typename L::I;
+
+        I x0 = fastFloor<L>(x);
+        I y0 = fastFloor<L>(y);
+
+        const F xd0 = L::sub(x, L::toFloat(x0));
+        const F yd0 = L::sub(y, L::toFloat(y0));
+        const F xd1 = L::sub(xd0, L::splat(1.0f));
+        const F yd1 = L::sub(yd0, L::splat(1.0f));
+
+        const F xs = interpQuintic<L>(xd0);
+        const F ys = interpQuintic<L>(yd0);
+
+        x0 = L::mulInt(x0, L::splatInt(PRIME_X));
+        y0 = L::mulInt(y0, L::splatInt(PRIME_Y));
+        const I x1 = L::addInt(x0, L::splatInt(PRIME_X));
+        const I y1 = L::addInt(y0, L::splatInt(PRIME_Y));
+
+        const F xf0 = lerp<L>(gradCoord<L>(seed, x0, y0, xd0, yd0), gradCoord<L>(seed, x1, y0, xd1, yd0), xs);
+        const F xf1 = lerp<L>(gradCoord<L>(seed, x0, y1, xd0, yd1), gradCoord<L>(seed, x1, y1, xd1, yd1), xs);
+
+        return L::mul(lerp<L>(xf0, xf1, ys), L::splat(1.4247691104677813f));
+    }
+
+    // Two offset rotated cube grids, coordinates must already be rotated
+    template <typename L>
+    typename L::F singleOpenSimplex2(typename L::I seed, typename L::F x, typename L::F y, typename L::F z)
+    {
+        using F = typename L::F;
+        using I = typename L::I;
+        using M = typename L::M;
+
+        I i = fastRound<L>(x);
+        I j = fastRound<L>(y);
+        I k = fastRound<L>(z);
+        F x0 = L::sub(x, L::toFloat(i));
+        F y0 = L::sub(y, L::toFloat(j));
+        F z0 = L::sub(z, L::toFloat(k));
+
+        // -1 where the offset is >= 0, 1 otherwise
+        I xNSign = L::orInt(L::truncate(L::sub(L::splat(-1.0f), x0)), L::splatInt(1));
+        I yNSign = L::orInt(L::truncate(L::sub(L::splat(-1.0f), y0)), L::splatInt(1));
+        I zNSign = L::orInt(L::truncate(L::sub(L::splat(-1.0f), z0)), L::splatInt(1));
+
+        F ax0 = L::mul(L::toFloat(xNSign), L::mul(x0, L::splat(-1.0f)));
+        F ay0 = L::mul(L::toFloat(yNSign), L::mul(y0, L::splat(-1.0f)));
+        F az0 = L::mul(L::toFloat(zNSign), L::mul(z0, L::splat(-1.0f)));
+
+        i = L::mulInt(i, L::splatInt(PRIME_X));
+        j = L::mulInt(j, L::splatInt(PRIME_Y));
+        k = L::mulInt(k, L::splatInt(PRIME_Z));
+
+        const F zero = L::splat(0.0f);
+        F value = zero;
+        F a = L::sub(L::sub(L::splat(0.6f), L::mul(x0, x0)), L::add(L::mul(y0, y0), L::mul(z0, z0)));
+
+        for (int l = 0;; l++)
+        {
+            const F aa = L::mul(a, a);
+            const F contributionA = L::mul(L::mul(aa, aa), gradCoord<L>(seed, i, j, k, x0, y0, z0));
+            value = L::add(value, L::select(L::greater(a, zero), contributionA, zero));
+
+            // Step towards whichever axis the point is furthest along
+            const M stepX = L::maskAnd(L::greaterEqual(ax0, ay0), L::greaterEqual(ax0, az0));
+            const M stepY = L::maskAndNot(stepX, L::maskAnd(L::greater(ay0, ax0), L::greaterEqual(ay0, az0)));
+            const M stepZ = L::maskNot(L::maskOr(stepX, stepY));
+
+            const F xSign = L::toFloat(xNSign);
+            const F ySign = L::toFloat(yNSign);
+            const F zSign = L::toFloat(zNSign);
+            const F x1 = L::add(x0, L::select(stepX, xSign, zero));
+            const F y1 = L::add(y0, L::select(stepY, ySign, zero));
+            const F z1 = L::add(z0, L::select(stepZ, zSign, zero));
+
+            const F bStep = L::select(stepX, L::mul(L::add(xSign, xSign), x1),
+                                      L::select(stepY, L::mul(L::add(ySign, ySign), y1), L::mul(L::add(zSign, zSign), z1)));
+            const F b = L::sub(L::add(a, L::splat(1.0f)), bStep);
+
+            const I zeroInt = L::splatInt(0);
+            const I i1 = L::subInt(i, L::selectInt(stepX, L::mulInt(xNSign, L::splatInt(PRIME_X)), zeroInt));
+            const I j1 = L::subInt(j, L::selectInt(stepY, L::mulInt(yNSign, L::splatInt(PRIME_Y)), zeroInt));
+            const I k1 = L::subInt(k, L::selectInt(stepZ, L::mulInt(zNSign, L::splatInt(PRIME_Z)), zeroInt));
+
+            const F bb = L::mul(b, b);
+            const F contributionB = L::mul(L::mul(bb, bb), gradCoord<L>(seed, i1, j1, k1, x1, y1, z1));
+            value = L::add(value, L::select(L::greater(b, zero), contributionB, zero));
+
+            if (l == 1)
+                break;
+
+            ax0 = L::sub(L::splat(0.5f), ax0);
+            ay0 = L::sub(L::splat(0.5f), ay0);
+            az0 = L::sub(L::splat(0.5f), az0);
+
+            x0 = L::mul(xSign, ax0);
+            y0 = L::mul(ySign, ay0);
+            z0 = L::mul(zSign, az0);
+
+            a = L::add(a, L::sub(L::sub(L::splat(0.75f), ax0), L::add(ay0, az0)));
+
+            i = L::addInt(i, L::andInt(L::shiftRight(xNSign, 1), L::splatInt(PRIME_X)));
+            j = L::addInt(j, L::andInt(L::shiftRight(yNSign, 1), L::splatInt(PRIME_Y)));
+            k = L::addInt(k, L::andInt(L::shiftRight(zNSign, 1), L::splatInt(PRIME_Z)));
+
+            xNSign = L::subInt(zeroInt, xNSign);
+            yNSign = L::subInt(zeroInt, yNSign);
+            zNSign = L::subInt(zeroInt, zNSign);
+
+            seed = L::xorInt(seed, L::splatInt(-1));
+        }
+
+        return L::mul(value, L::splat(32.69428253173828125f));
+    }
+
+    template <typename L>
+    typename L::F perlin2DLanes(int seed, float frequency, const float *x, const float *y)
+    {
+        const typename L::F f = L::splat(frequency);
+        return singlePerlin<L>(L::splatInt(seed), L::mul(L::load(x), f), L::mul(L::load(y), f));
+    }
+
+    template <typename L>
+    typename L::F openSimplex2_3DLanes(int seed, float frequency, const float *x, const float *y, const float *z)
+    {
+        using F = typename L::F;
+
+        const F f = L::splat(frequency);
+        const F xf = L::mul(L::load(x), f);
+        const F yf = L::mul(L::load(y), f);
+        const F zf = L::mul(L::load(z), f);
+
+        // FastNoiseLite's default OpenSimplex2 rotation
+        const F r = L::mul(L::add(L::add(xf, yf), zf), L::splat((float)(2.0 / 3.0)));
+        return singleOpenSimplex2<L>(L::splatInt(seed), L::sub(r, xf), L::sub(r, yf), L::sub(r, zf));
+    }
+
+    // Runs a kernel over full vectors, then pads the tail out to one more vector
+    template <typename Kernel>
+    void forEachVector(size_t count, float *out, Kernel &&kernel)
+    {
+        constexpr int WIDTH = Lanes::WIDTH;
+        size_t i = 0;
+        for (; i + WIDTH <= count; i += WIDTH)
+            Lanes::store(out + i, kernel(i));
+
+        if (i < count)
+        {
+            float tail[WIDTH];
+            Lanes::store(tail, kernel(i));
+            for (size_t j = i; j < count; j++)
+                out[j] = tail[j - i];
+        }
+    }
+
+    // Copies the tail of an input span into a padded buffer so kernels can always load a full vector
+    struct PaddedTail
+    {
+        float values[Lanes::WIDTH] = {};
+
+        const float *from(const float *src, size_t offset, size_t count)
+        {
+            if (offset + Lanes::WIDTH <= count)
+                return src + offset;
+            for (size_t i = offset; i < count; i++)
+                values[i - offset] = src[i];
+            return values;
+        }
+    };
+}
+
+namespace BatchNoise
+{
+    void perlin2D(int seed, float frequency, const float *x, const float *y, float *out, size_t count)
+    {
+        PaddedTail xTail, yTail;
+        forEachVector(count, out, [&](size_t i)
+                      { return perlin2DLanes<Lanes>(seed, frequency, xTail.from(x, i, count), yTail.from(y, i, count)); });
+    }
+
+    void openSimplex2_3D(int seed, float frequency, const float *x, const float *y, const float *z, float *out, size_t count)
+    {
+        PaddedTail xTail, yTail, zTail;
+        forEachVector(count, out, [&](size_t i)
+                      { return openSimplex2_3DLanes<Lanes>(seed, frequency, xTail.from(x, i, count), yTail.from(y, i, count), zTail.from(z, i, count)); });
+    }
+
+    const char *getKernelName()
+    {
+        return KERNEL_NAME;
+    }
+}
@@ -0,0 +1,74 @@
+#include "Noise/NoiseTileCache.h"
+#include "Performance/Profiler.h"
+
+#include <algorithm>
+
+NoiseTileCache::NoiseTileCache(std::string name, size_t capacity, TileFiller filler)
+    : name_(std::move(name)), capacity_(std::max<size_t>(capacity, 1)), filler_(std::move(filler))
+{
+}
+
+std::shared_ptr<const NoiseTileCache::Tile> NoiseTileCache::getTile(int regionX, int regionZ)
+{
+    const Key key = makeKey(regionX, regionZ);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tiles_.find(key);
+        if (it != tiles_.end())
+        {
+            lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+            hits_++;
+            return it->second.tile;
+        }
+    }
+
+    // Sample outside the lock so other threads can keep hitting the cache meanwhile
+    auto tile = std::make_shared<Tile>();
+    filler_(regionX * TILE_SIZE, regionZ * TILE_SIZE, *tile);
+    misses_++;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Another thread may have filled the same tile first, keep theirs
+    auto it = tiles_.find(key);
+    if (it != tiles_.end())
+        return it->second.tile;
+
+    if (tiles_.size() >= capacity_)
+    {
+        tiles_.erase(lru_.back());
+        lru_.pop_back();
+    }
+    lru_.push_front(key);
+    tiles_.emplace(key, Entry{tile, lru_.begin()});
+    return tile;
+}
+
+void NoiseTileCache::sample(int x, int z, int sizeX, int sizeZ, float *out)
+{
+    // Walk the block one tile at a time, a chunk aligned request usually falls inside a single tile
+    for (int regionZ = getRegion(z); regionZ <= getRegion(z + sizeZ - 1); regionZ++)
+    {
+        for (int regionX = getRegion(x); regionX <= getRegion(x + sizeX - 1); regionX++)
+        {
+            const auto tile = getTile(regionX, regionZ);
+            const int originX = regionX * TILE_SIZE;
+            const int originZ = regionZ * TILE_SIZE;
+
+            const int minX = std::max(x, originX), maxX = std::min(x + sizeX, originX + TILE_SIZE);
+            const int minZ = std::max(z, originZ), maxZ = std::min(z + sizeZ, originZ + TILE_SIZE);
+            for (int worldZ = minZ; worldZ < maxZ; worldZ++)
+            {
+                const float *row = tile->data() + (worldZ - originZ) * TILE_SIZE;
+                std::copy(row + (minX - originX), row + (maxX - originX), out + (worldZ - z) * sizeX + (minX - x));
+            }
+        }
+    }
+}
+
+void NoiseTileCache::reportStats() const
+{
+    const size_t hits = hits_.load();
+    const size_t total = hits + misses_.load();
+    if (total > 0)
+        Profiler::get().recordValue(name_ + " hit rate (%)", 100.0 * hits / total);
+}
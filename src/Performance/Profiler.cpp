@@ -26,6 +26,12 @@ void Profiler::record(const std::string &name, const double duration)
     timings_[name].push_back(duration);
 }
 
+void Profiler::recordValue(const std::string &name, const double value)
+{
+    std::unique_lock<std::mutex> lock(timingsMutex_);
+    values_[name] = value;
+}
+
 void Profiler::renderStats()
 {
     std::unique_lock<std::mutex> lock(timingsMutex_);
@@ -35,5 +41,11 @@ void Profiler::renderStats()
         std::cout << name << ": " << avg << "ms" << std::endl;
     }
 
+    for (const auto &[name, value] : values_)
+    {
+        std::cout << name << ": " << value << std::endl;
+    }
+
     timings_.clear();
+    values_.clear();
 };
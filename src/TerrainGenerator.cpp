@@ -1,12 +1,41 @@
 #include "TerrainGenerator.h"
+#include "Constants.h"
+#include "Noise/BatchNoise.h"
 
-TerrainGenerator::TerrainGenerator()
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+TerrainGenerator::TerrainGenerator(int seed)
+    : seed_(seed),
+      heightNoiseTiles_("Height noise tiles", Constants::NOISE_TILE_CACHE_SIZE,
+                        [this](int originX, int originZ, NoiseTileCache::Tile &tile)
+                        { fillTerrainNoiseTile(originX, originZ, tile); }),
+      temperatureTiles_("Temperature tiles", Constants::NOISE_TILE_CACHE_SIZE,
+                        [this](int originX, int originZ, NoiseTileCache::Tile &tile)
+                        { fillClimateTile(temperatureNoise, originX, originZ, tile); }),
+      humidityTiles_("Humidity tiles", Constants::NOISE_TILE_CACHE_SIZE,
+                     [this](int originX, int originZ, NoiseTileCache::Tile &tile)
+                     { fillClimateTile(humidityNoise, originX, originZ, tile); })
 {
     terrainNoise.SetNoiseType(FastNoiseLite::NoiseType::NoiseType_Perlin);
+    terrainNoise.SetSeed(seed_);
+    terrainNoise.SetFrequency(TERRAIN_FREQUENCY);
     caveNoise.SetNoiseType(FastNoiseLite::NoiseType::NoiseType_OpenSimplex2);
+    caveNoise.SetSeed(seed_);
+    // Each cave octave scales its own coordinates, the noise itself is never mutated after this
+    caveNoise.SetFrequency(CAVE_FREQUENCY);
+
+    // Climate gets its own seeds so it doesn't line up with the terrain
+    temperatureNoise.SetNoiseType(FastNoiseLite::NoiseType::NoiseType_OpenSimplex2);
+    temperatureNoise.SetSeed(seed_ + 1);
+    temperatureNoise.SetFrequency(Constants::BIOME_CLIMATE_FREQUENCY);
+    humidityNoise.SetNoiseType(FastNoiseLite::NoiseType::NoiseType_OpenSimplex2);
+    humidityNoise.SetSeed(seed_ + 2);
+    humidityNoise.SetFrequency(Constants::BIOME_CLIMATE_FREQUENCY);
 }
 
-float TerrainGenerator::getTerrainNoise(const float x, const float z)
+float TerrainGenerator::getTerrainNoise(const float x, const float z) const
 {
     float result = 0.0f;
     float amplitude = 1.0f;
@@ -26,19 +55,233 @@ float TerrainGenerator::getTerrainNoise(const float x, const float z)
     return (result / maxValue + 1.0f) * 0.5f;
 }
 
-float TerrainGenerator::getCaveNoise(const float x, const float y, const float z)
+float TerrainGenerator::getCaveNoise(const float x, const float y, const float z) const
 {
-    caveNoise.SetFrequency(0.02f);
-    float largeCaves = caveNoise.GetNoise(x, y, z) * 0.5f;
+    // Large caves
+    float largeCaves = caveNoise.GetNoise(x * 0.02f, y * 0.02f, z * 0.02f) * 0.5f;
 
     // Medium cave details
-    caveNoise.SetFrequency(0.03f);
-    float mediumCaves = caveNoise.GetNoise(x, y, z) * 0.3f;
+    float mediumCaves = caveNoise.GetNoise(x * 0.03f, y * 0.03f, z * 0.03f) * 0.3f;
 
     // Small cave details
-    caveNoise.SetFrequency(0.05f);
-    float smallCaves = caveNoise.GetNoise(x, y, z) * 0.2f;
+    float smallCaves = caveNoise.GetNoise(x * 0.05f, y * 0.05f, z * 0.05f) * 0.2f;
 
     // normalize [0 - 1]
     return (largeCaves + mediumCaves + smallCaves + 1) * 0.5f;
 }
+
+void TerrainGenerator::getTerrainNoiseBatch(const float *x, const float *z, float *out, size_t count) const
+{
+    for (size_t start = 0; start < count; start += BATCH_BLOCK)
+    {
+        const size_t n = std::min(BATCH_BLOCK, count - start);
+        float octaveX[BATCH_BLOCK], octaveZ[BATCH_BLOCK], octave[BATCH_BLOCK], result[BATCH_BLOCK] = {};
+
+        float amplitude = 1.0f;
+        float frequency = 0.3f;
+        float maxValue = 0.0f;
+
+        // Same octaves as getTerrainNoise, one batch per octave
+        for (int i = 0; i < 5; i++)
+        {
+            for (size_t s = 0; s < n; s++)
+            {
+                octaveX[s] = x[start + s] * frequency;
+                octaveZ[s] = z[start + s] * frequency;
+            }
+            BatchNoise::perlin2D(seed_, TERRAIN_FREQUENCY, octaveX, octaveZ, octave, n);
+            for (size_t s = 0; s < n; s++)
+                result[s] += octave[s] * amplitude;
+
+            maxValue += amplitude;
+            amplitude *= 0.5f;
+            frequency *= 2.0f;
+        }
+
+        for (size_t s = 0; s < n; s++)
+            out[start + s] = (result[s] / maxValue + 1.0f) * 0.5f;
+    }
+}
+
+void TerrainGenerator::getColumnGrid(const int x, const int z, const int sizeX, const int sizeZ, TerrainColumn *out) const
+{
+    const size_t count = static_cast<size_t>(sizeX) * sizeZ;
+    std::vector<float> heightNoise(count), temperature(count), humidity(count);
+    heightNoiseTiles_.sample(x, z, sizeX, sizeZ, heightNoise.data());
+    temperatureTiles_.sample(x, z, sizeX, sizeZ, temperature.data());
+    humidityTiles_.sample(x, z, sizeX, sizeZ, humidity.data());
+
+    for (size_t i = 0; i < count; i++)
+        out[i] = blendBiomes(heightNoise[i], temperature[i], humidity[i]);
+}
+
+void TerrainGenerator::reportStats() const
+{
+    heightNoiseTiles_.reportStats();
+    temperatureTiles_.reportStats();
+    humidityTiles_.reportStats();
+}
+
+void TerrainGenerator::fillTerrainNoiseTile(int originX, int originZ, NoiseTileCache::Tile &tile) const
+{
+    constexpr int SIZE = NoiseTileCache::TILE_SIZE;
+    std::vector<float> columnX(tile.size()), columnZ(tile.size());
+    for (int dz = 0; dz < SIZE; dz++)
+    {
+        for (int dx = 0; dx < SIZE; dx++)
+        {
+            columnX[dx + dz * SIZE] = (float)(originX + dx);
+            columnZ[dx + dz * SIZE] = (float)(originZ + dz);
+        }
+    }
+
+    getTerrainNoiseBatch(columnX.data(), columnZ.data(), tile.data(), tile.size());
+}
+
+void TerrainGenerator::getCaveNoiseBatch(const float *x, const float *y, const float *z, float *out, size_t count) const
+{
+    // Octave scales and weights match getCaveNoise
+    constexpr float scales[3] = {0.02f, 0.03f, 0.05f};
+    constexpr float weights[3] = {0.5f, 0.3f, 0.2f};
+
+    for (size_t start = 0; start < count; start += BATCH_BLOCK)
+    {
+        const size_t n = std::min(BATCH_BLOCK, count - start);
+        float octaveX[BATCH_BLOCK], octaveY[BATCH_BLOCK], octaveZ[BATCH_BLOCK];
+        float octaves[3][BATCH_BLOCK];
+
+        for (int i = 0; i < 3; i++)
+        {
+            for (size_t s = 0; s < n; s++)
+            {
+                octaveX[s] = x[start + s] * scales[i];
+                octaveY[s] = y[start + s] * scales[i];
+                octaveZ[s] = z[start + s] * scales[i];
+            }
+            BatchNoise::openSimplex2_3D(seed_, CAVE_FREQUENCY, octaveX, octaveY, octaveZ, octaves[i], n);
+        }
+
+        for (size_t s = 0; s < n; s++)
+            out[start + s] = (octaves[0][s] * weights[0] + octaves[1][s] * weights[1] + octaves[2][s] * weights[2] + 1) * 0.5f;
+    }
+}
+
+void TerrainGenerator::fillClimateTile(const FastNoiseLite &noise, int originX, int originZ, NoiseTileCache::Tile &tile) const
+{
+    constexpr int SIZE = NoiseTileCache::TILE_SIZE;
+    constexpr int GRID = Constants::BIOME_GRID_SIZE;
+    constexpr int POINTS = SIZE / GRID + 1;
+
+    // The lattice includes the tile's far edges, which land on the same world positions as the next tile's near edges
+    std::array<float, POINTS * POINTS> lattice;
+    for (int lz = 0; lz < POINTS; lz++)
+    {
+        for (int lx = 0; lx < POINTS; lx++)
+        {
+            const float value = noise.GetNoise((float)(originX + lx * GRID), (float)(originZ + lz * GRID));
+            lattice[lx + lz * POINTS] = (value + 1.0f) * 0.5f;
+        }
+    }
+
+    for (int dz = 0; dz < SIZE; dz++)
+    {
+        const int lz = dz / GRID;
+        const float fz = (float)(dz % GRID) / GRID;
+        for (int dx = 0; dx < SIZE; dx++)
+        {
+            const int lx = dx / GRID;
+            const float fx = (float)(dx % GRID) / GRID;
+
+            const float near = lattice[lx + lz * POINTS] + (lattice[lx + 1 + lz * POINTS] - lattice[lx + lz * POINTS]) * fx;
+            const float far = lattice[lx + (lz + 1) * POINTS] + (lattice[lx + 1 + (lz + 1) * POINTS] - lattice[lx + (lz + 1) * POINTS]) * fx;
+            tile[dx + dz * SIZE] = near + (far - near) * fz;
+        }
+    }
+}
+
+TerrainColumn TerrainGenerator::blendBiomes(float heightNoise, float temperature, float humidity)
+{
+    // Inverse distance weights in climate space, the closer a biome's climate the more it counts
+    float totalWeight = 0.0f;
+    float baseHeight = 0.0f, heightVariation = 0.0f, stoneLevel = 0.0f, caveThreshold = 0.0f;
+    int dominant = 0;
+    float dominantWeight = 0.0f;
+    for (int i = 0; i < BiomeTypeCount; i++)
+    {
+        const BiomeProperties &biome = Biomes::get(static_cast<BiomeType>(i));
+        const float dt = temperature - biome.temperature;
+        const float dh = humidity - biome.humidity;
+        const float weight = 1.0f / std::pow(dt * dt + dh * dh + 1e-4f, Constants::BIOME_BLEND_SHARPNESS);
+
+        totalWeight += weight;
+        baseHeight += biome.baseHeight * weight;
+        heightVariation += biome.heightVariation * weight;
+        stoneLevel += biome.stoneLevel * weight;
+        caveThreshold += biome.caveThreshold * weight;
+        if (weight > dominantWeight)
+        {
+            dominantWeight = weight;
+            dominant = i;
+        }
+    }
+
+    baseHeight /= totalWeight;
+    heightVariation /= totalWeight;
+
+    const BiomeProperties &dominantBiome = Biomes::get(static_cast<BiomeType>(dominant));
+    TerrainColumn column;
+    column.height = (int)baseHeight + (int)((heightNoise - 0.5f) * heightVariation * 2.0f);
+    column.stoneLevel = (int)(stoneLevel / totalWeight);
+    column.caveThreshold = caveThreshold / totalWeight;
+    column.biome = static_cast<BiomeType>(dominant);
+    column.surfaceBlock = dominantBiome.surfaceBlock;
+    column.fillerBlock = dominantBiome.fillerBlock;
+    return column;
+}
+
+void CaveDensityGrid::build(const TerrainGenerator &generator, int chunkWorldX, int chunkWorldZ, int minY, int maxY)
+{
+    const int firstLayer = std::max(minY, 0) / STEP_Y;
+    const int endLayer = std::min(std::max(maxY, 0) / STEP_Y + 2, POINTS_Y);
+    if (firstLayer >= endLayer)
+        return;
+
+    // Lay the lattice coordinates out in sample order and evaluate them in one batch
+    std::array<float, POINTS_X * POINTS_Y * POINTS_Z> x, y, z;
+    for (int ly = firstLayer; ly < endLayer; ly++)
+    {
+        for (int lz = 0; lz < POINTS_Z; lz++)
+        {
+            for (int lx = 0; lx < POINTS_X; lx++)
+            {
+                const int index = getSampleIndex(lx, ly, lz);
+                x[index] = (float)(chunkWorldX + lx * STEP_XZ);
+                y[index] = (float)(ly * STEP_Y);
+                z[index] = (float)(chunkWorldZ + lz * STEP_XZ);
+            }
+        }
+    }
+
+    const int first = getSampleIndex(0, firstLayer, 0);
+    generator.getCaveNoiseBatch(x.data() + first, y.data() + first, z.data() + first, samples_.data() + first,
+                                getSampleIndex(0, endLayer, 0) - first);
+}
+
+float CaveDensityGrid::sample(int x, int y, int z) const
+{
+    const int lx = x / STEP_XZ, ly = y / STEP_Y, lz = z / STEP_XZ;
+    const float fx = (float)(x % STEP_XZ) / STEP_XZ;
+    const float fy = (float)(y % STEP_Y) / STEP_Y;
+    const float fz = (float)(z % STEP_XZ) / STEP_XZ;
+
+    auto lerp = [](float a, float b, float t)
+    { return a + (b - a) * t; };
+
+    // Blend along x, then z, then y
+    const float c00 = lerp(samples_[getSampleIndex(lx, ly, lz)], samples_[getSampleIndex(lx + 1, ly, lz)], fx);
+    const float c01 = lerp(samples_[getSampleIndex(lx, ly, lz + 1)], samples_[getSampleIndex(lx + 1, ly, lz + 1)], fx);
+    const float c10 = lerp(samples_[getSampleIndex(lx, ly + 1, lz)], samples_[getSampleIndex(lx + 1, ly + 1, lz)], fx);
+    const float c11 = lerp(samples_[getSampleIndex(lx, ly + 1, lz + 1)], samples_[getSampleIndex(lx + 1, ly + 1, lz + 1)], fx);
+
+    return lerp(lerp(c00, c01, fz), lerp(c10, c11, fz), fy);
+}
@@ -1,5 +1,6 @@
 #include "TextureAtlas.h"
 #include "Block/BlockFaceData.h"
+#include "Block/BlockRegistry.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -37,6 +38,12 @@ TextureAtlas::TextureAtlas()
     initBlockUVs();
 }
 
+TextureAtlas::TextureAtlas(int atlasWidth, int atlasHeight)
+    : ID_(0), atlasWidth_(atlasWidth), atlasHeight_(atlasHeight), tileSize_(16)
+{
+    initBlockUVs();
+}
+
 void TextureAtlas::bindUnit(unsigned int unit)
 {
 
@@ -46,44 +53,19 @@ void TextureAtlas::bindUnit(unsigned int unit)
 
 void TextureAtlas::initBlockUVs()
 {
-    std::unordered_map<BlockType, BlockTextureAtlasIndicies> blockIndicies;
-    //                                        top             side                bottom
-    blockIndicies[BlockType::Grass] = {glm::ivec2(0, 0), glm::ivec2(3, 0), glm::ivec2(2, 0)};
-    blockIndicies[BlockType::Dirt] = {glm::ivec2(2, 0), glm::ivec2(2, 0), glm::ivec2(2, 0)};
-    blockIndicies[BlockType::Stone] = {glm::ivec2(1, 0), glm::ivec2(1, 0), glm::ivec2(1, 0)};
-    blockIndicies[BlockType::Cobblestone] = {glm::ivec2(0, 1), glm::ivec2(0, 1), glm::ivec2(0, 1)};
-    blockIndicies[BlockType::Log] = {glm::ivec2(5, 1), glm::ivec2(4, 1), glm::ivec2(4, 1)};
-    blockIndicies[BlockType::Plank] = {glm::ivec2(4, 0), glm::ivec2(4, 0), glm::ivec2(4, 0)};
-    blockIndicies[BlockType::Brick] = {glm::ivec2(7, 0), glm::ivec2(7, 0), glm::ivec2(7, 0)};
-
-    for (const auto &[type, indices] : blockIndicies)
+    for (int type = 0; type < BlockTypeCount; type++)
     {
-        BlockUVs blockUVs;
-
-        blockUVs.top = getTileUVs(indices.top.x, indices.top.y);
-        blockUVs.side = getTileUVs(indices.side.x, indices.side.y);
-        blockUVs.bottom = getTileUVs(indices.bottom.x, indices.bottom.y);
-
-        blockUVsMap_[type] = blockUVs;
+        const auto &tiles = BlockRegistry::get(static_cast<BlockType>(type)).faceTiles;
+        for (int face = 0; face < 6; face++)
+        {
+            faceUVs_[type][face] = getTileUVs(tiles[face].x, tiles[face].y);
+        }
     }
 }
 
 const std::array<glm::vec2, 4> &TextureAtlas::getBlockFaceUVs(BlockType type, BlockFaces face) const
 {
-    const auto &blockUVs = blockUVsMap_.at(type);
-
-    if (face == BlockFaces::Top)
-    {
-        return blockUVs.top;
-    }
-    else if (face == BlockFaces::Bottom)
-    {
-        return blockUVs.bottom;
-    }
-    else
-    {
-        return blockUVs.side;
-    }
+    return faceUVs_[type][static_cast<int>(face)];
 }
 
 std::array<glm::vec2, 4> TextureAtlas::getTileUVs(int tileX, int tileY)
@@ -1,8 +1,8 @@
 #include "World.h"
 #include "Chunk/ChunkManager.h"
 #include "Chunk/ChunkCoord.h"
-#include "Block/Block.h"
 #include "Block/BlockFaceData.h"
+#include "Block/BlockRegistry.h"
 #include "Constants.h"
 #include "Camera.h"
 
@@ -13,13 +13,14 @@
 
 World::World(Camera &camera)
     : camera_(camera),
-      pipeline_(),
+      terrainGenerator_(Constants::WORLD_SEED),
+      featureGenerator_(terrainGenerator_, Constants::WORLD_SEED),
       chunkManager_(camera),
-      lightSystem_(this, &chunkManager_),
+      pipeline_(),
       lastPlayerChunk_(worldToChunkCoords(glm::ivec3(camera_.Position - glm::vec3(1)))),
       raycaster(*this, camera)
 {
-    pipeline_.init(&chunkManager_, &lightSystem_);
+    pipeline_.init(&chunkManager_, &lightSystem_, &terrainGenerator_, &featureGenerator_);
     chunkManager_.init(&pipeline_);
 }
 
@@ -34,6 +35,7 @@ void World::update()
     }
 
     chunkManager_.update();
+    terrainGenerator_.reportStats();
     updateSelectedBlockOutline();
 }
 
@@ -48,56 +50,50 @@ void World::render()
 
 void World::breakBlock()
 {
-    // if (raycaster.cast())
-    // {
-    //     glm::ivec3 blockHitPos = raycaster.getHitBlockPosition();
-    //     auto chunk = chunkManager_.getChunk(worldToChunkCoords(blockHitPos));
-    //     if (chunk)
-    //     {
-    //         chunk->removeBlockAt(getBlockLocalPosition(blockHitPos));
-    //         chunk->setState(ChunkState::NEEDS_LIGHT_UPDATE);
-    //     }
-    // }
+    if (!raycaster.cast())
+        return;
+
+    const glm::ivec3 blockHitPos = raycaster.getHitBlockPosition();
+    auto chunk = getLoadedChunk(worldToChunkCoords(blockHitPos));
+    if (!chunk)
+        return;
+
+    // The hole opens onto the blocks around it, placeholder stone there would show as a fake wall
+    for (const auto &offset : BlockFaceData::FACE_OFFSETS)
+    {
+        const glm::ivec3 neighborPos = blockHitPos + offset;
+        if (neighborPos.y < 0 || neighborPos.y >= Constants::CHUNK_SIZE_Y)
+            continue;
+
+        const int sectionIndex = neighborPos.y / Constants::SECTION_SIZE;
+        auto neighborChunk = getLoadedChunk(worldToChunkCoords(neighborPos));
+        if (neighborChunk && !neighborChunk->isSectionGenerated(sectionIndex))
+            pipeline_.materializeSection(neighborChunk, sectionIndex);
+    }
+
+    const glm::ivec3 localPos = getBlockLocalPosition(blockHitPos);
+    chunk->removeBlockAt(localPos);
+    pipeline_.onBlockChanged(chunk, localPos);
 }
 
 void World::placeBlock()
 {
-    // if (raycaster.cast())
-    // {
-    //     glm::ivec3 blockHitPos = raycaster.getHitBlockPosition();
-    //     BlockFaces hitFace = raycaster.getHitBlockFace();
-    //     glm::ivec3 dir;
-
-    //     switch (hitFace)
-    //     {
-    //     case BlockFaces::Front:
-    //         dir = glm::ivec3(0, 0, 1);
-    //         break;
-    //     case BlockFaces::Back:
-    //         dir = glm::ivec3(0, 0, -1);
-    //         break;
-    //     case BlockFaces::Left:
-    //         dir = glm::ivec3(-1, 0, 0);
-    //         break;
-    //     case BlockFaces::Right:
-    //         dir = glm::ivec3(1, 0, 0);
-    //         break;
-    //     case BlockFaces::Bottom:
-    //         dir = glm::ivec3(0, -1, 0);
-    //         break;
-    //     case BlockFaces::Top:
-    //         dir = glm::ivec3(0, 1, 0);
-    //         break;
-    //     }
-
-    //     glm::ivec3 posToPlace = blockHitPos + dir;
-    //     auto chunk = chunkManager_.getChunk(worldToChunkCoords(posToPlace));
-    //     if (chunk)
-    //     {
-    //         chunk->setBlockAt(getBlockLocalPosition(posToPlace), playerBlockType_);
-    //         chunk->setState(ChunkState::NEEDS_LIGHT_UPDATE);
-    //     }
-    // }
+    if (!raycaster.cast())
+        return;
+
+    // The block goes in front of the face that was hit, FACE_OFFSETS is in BlockFaces order
+    const glm::ivec3 faceOffset = BlockFaceData::FACE_OFFSETS[static_cast<int>(raycaster.getHitBlockFace())];
+    const glm::ivec3 posToPlace = raycaster.getHitBlockPosition() + faceOffset;
+    if (posToPlace.y < 0 || posToPlace.y >= Constants::CHUNK_SIZE_Y)
+        return;
+
+    auto chunk = getLoadedChunk(worldToChunkCoords(posToPlace));
+    if (!chunk)
+        return;
+
+    const glm::ivec3 localPos = getBlockLocalPosition(posToPlace);
+    chunk->setBlockAt(localPos, playerBlockType_);
+    pipeline_.onBlockChanged(chunk, localPos);
 }
 
 void World::setPlayerBlockType(BlockType type)
@@ -139,21 +135,20 @@ void World::loadNewChunks(ChunkCoord center)
 
 void World::unloadDistantChunks()
 {
-    // const ChunkCoord playerPos = worldToChunkCoords(glm::ivec3(camera_.Position));
-    // std::vector<ChunkCoord> chunkCoordsToRemove;
+    const ChunkCoord playerPos = worldToChunkCoords(glm::ivec3(camera_.Position));
+    std::vector<ChunkCoord> chunkCoordsToRemove;
 
-    // // Pass to chunkManagers visitor function which checks if every coord/chunk pair
-    // chunkManager_.forEachChunk([&](const ChunkCoord coord, std::shared_ptr<Chunk> chunk) { //
-    //     // if (!isInRenderDistance(coord.x, coord.z, playerPos.x, playerPos.z) && chunk->canUnload())
-    //     if (!isInRenderDistance(coord.x, coord.z, playerPos.x, playerPos.z))
-    //         chunkCoordsToRemove.push_back(coord);
-    // });
+    // Pass to chunkManagers visitor function which checks if every coord/chunk pair
+    chunkManager_.forEachChunk([&](const ChunkCoord coord, std::shared_ptr<Chunk>) { //
+        if (!isInRenderDistance(coord.x, coord.z, playerPos.x, playerPos.z))
+            chunkCoordsToRemove.push_back(coord);
+    });
 
-    // // Remove chunks outside of lock
-    // for (const auto &coord : chunkCoordsToRemove)
-    // {
-    //     chunkManager_.removeChunk(coord);
-    // }
+    // Remove chunks after iterating, removing invalidates the visitor's iterators
+    for (const auto &coord : chunkCoordsToRemove)
+    {
+        chunkManager_.removeChunk(coord);
+    }
 }
 
 void World::updateSelectedBlockOutline()
@@ -162,9 +157,17 @@ void World::updateSelectedBlockOutline()
     {
         // Global hit position
         auto blockHitPos = raycaster.getHitBlockPosition();
-        Block *blockPtr = getBlockGlobal(blockHitPos);
 
-        if (!blockPtr)
+        // Looking at placeholder stone, give it its real blocks. Edits go through the targeted block
+        // so this covers them too
+        const int sectionIndex = blockHitPos.y / Constants::SECTION_SIZE;
+        auto hitChunk = getGeneratedChunk(worldToChunkCoords(blockHitPos));
+        if (hitChunk && !hitChunk->isSectionGenerated(sectionIndex))
+            pipeline_.materializeSection(hitChunk, sectionIndex);
+
+        auto blockType = getBlockGlobal(blockHitPos);
+
+        if (!blockType)
         {
             throw std::runtime_error("Block not found at " +
                                      std::to_string(blockHitPos.x) + ", " +
@@ -172,8 +175,7 @@ void World::updateSelectedBlockOutline()
                                      std::to_string(blockHitPos.z));
         }
 
-        Block &block = *blockPtr;
-        if (block.type != BlockType::Air)
+        if (BlockRegistry::isSolid(*blockType))
         {
             targetBlockPos_ = blockHitPos;
             hasTargetBlock_ = true;
@@ -191,6 +193,34 @@ const std::shared_ptr<Chunk> World::getChunk(const ChunkCoord &coord) const
     return chunkManager_.getChunk(coord);
 }
 
+std::shared_ptr<Chunk> World::getGeneratedChunk(const ChunkCoord &coord) const
+{
+    auto chunkPtr = chunkManager_.getChunk(coord);
+    if (!chunkPtr || chunkPtr->getState() < ChunkState::INITIAL_LIGHT_READY)
+        return nullptr;
+    return chunkPtr;
+}
+
+std::shared_ptr<Chunk> World::getLoadedChunk(const ChunkCoord &coord) const
+{
+    auto chunkPtr = chunkManager_.getChunk(coord);
+    if (!chunkPtr || chunkPtr->getState() != ChunkState::LOADED)
+        return nullptr;
+    return chunkPtr;
+}
+
+size_t World::getChunkMemoryUsage()
+{
+    size_t bytes = 0;
+    // Chunks still on a worker are skipped, their storage may be mid resize
+    chunkManager_.forEachChunk([&](const ChunkCoord, std::shared_ptr<Chunk> chunk)
+                               {
+                                   if (chunk->getState() >= ChunkState::INITIAL_LIGHT_READY)
+                                       bytes += chunk->getMemoryUsage();
+                               });
+    return bytes;
+}
+
 glm::ivec3 World::chunkToWorldCoords(ChunkCoord chunkCoords, glm::ivec3 localPos) const
 {
     int x = chunkCoords.x * Constants::CHUNK_SIZE_X + localPos.x;
@@ -227,17 +257,44 @@ glm::ivec3 World::localToGlobalPos(ChunkCoord chunkCoords, glm::ivec3 localPos)
                       chunkCoords.z * Constants::CHUNK_SIZE_Z + localPos.z);
 }
 
-Block *World::getBlockGlobal(const glm::ivec3 worldPos) const
+std::optional<BlockType> World::getBlockGlobal(const glm::ivec3 worldPos) const
 {
-
     auto localBlockPos = getBlockLocalPosition(worldPos);
+    if (!Chunk::blockPosInChunkBounds(localBlockPos))
+        return std::nullopt;
+
     ChunkCoord chunkCoord = worldToChunkCoords(worldPos);
-    auto chunkPtr = chunkManager_.getChunk(chunkCoord);
-    return (chunkPtr) ? chunkPtr->getBlockLocal(localBlockPos) : nullptr;
+    auto chunkPtr = getGeneratedChunk(chunkCoord);
+    if (!chunkPtr)
+        return std::nullopt;
+
+    return chunkPtr->getBlockType(localBlockPos);
 }
 
 bool World::isBlockSolid(glm::ivec3 blockWorldPos) const
 {
-    Block *block = getBlockGlobal(blockWorldPos);
-    return block->type != BlockType::Air;
+    auto localBlockPos = getBlockLocalPosition(blockWorldPos);
+    if (!Chunk::blockPosInChunkBounds(localBlockPos))
+        return false;
+
+    auto chunkPtr = getGeneratedChunk(worldToChunkCoords(blockWorldPos));
+    if (!chunkPtr)
+        return false;
+
+    // Everything above the column's heightmap is air, no need to look at the block data
+    if (localBlockPos.y > chunkPtr->getHeight(localBlockPos.x, localBlockPos.z))
+        return false;
+
+    return BlockRegistry::isSolid(chunkPtr->getBlockType(localBlockPos));
+}
+
+int World::getSurfaceHeight(int worldX, int worldZ) const
+{
+    const glm::ivec3 worldPos = glm::ivec3(worldX, 0, worldZ);
+    auto chunkPtr = getGeneratedChunk(worldToChunkCoords(worldPos));
+    if (!chunkPtr)
+        return -1;
+
+    const glm::ivec3 localPos = getBlockLocalPosition(worldPos);
+    return chunkPtr->getHeight(localPos.x, localPos.z);
 }
\ No newline at end of file
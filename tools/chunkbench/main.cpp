@@ -0,0 +1,415 @@
+// Chunk storage microbenchmarks, headless like light_bench. Each mode times one part of the chunk
+// code the same way every run so changes to it can be compared before and after.
+//
+//   access  Block get/set on palette sections against the flat array of blocks chunks used to keep
+//   layout  Terrain generation, sky light, meshing and block walks with the compiled in block layout,
+//           rebuild with -DCHUNK_BLOCK_LAYOUT=<name> to compare layouts
+//   pool    Streaming chunks in and out through ChunkPool against a fresh chunk and mesh buffers each time
+//   terrain Chunks generated per second by Chunk::generateTerrain against sampling noise for every block
+//
+// Usage: chunk_bench <access|layout|pool|terrain> [--iterations N]
+
+#include "Chunk/Chunk.h"
+#include "Chunk/ChunkLayout.h"
+#include "Chunk/ChunkMeshBuilder.h"
+#include "Chunk/ChunkPool.h"
+#include "Chunk/MeshData.h"
+#include "LightSystem.h"
+#include "TerrainGenerator.h"
+#include "TextureAtlas.h"
+#include "Constants.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace
+{
+    using namespace Constants;
+
+    constexpr int CHUNK_VOLUME = CHUNK_SIZE_X * CHUNK_SIZE_Y * CHUNK_SIZE_Z;
+
+    // Read results go here so the compiler can't drop the reads
+    volatile size_t readSink = 0;
+
+    // Runs the work the given number of times, the work returns how many units it got through
+    void runBenchmark(const std::string &name, const std::string &unit, int iterations, const std::function<size_t()> &work)
+    {
+        size_t units = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            units += work();
+        const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "  " << name << ": " << units / iterations << " " << unit << ", " << totalMs / iterations << "ms per run, ";
+        if (units > static_cast<size_t>(iterations))
+            std::cout << totalMs * 1e6 / static_cast<double>(units) << "ns per " << unit.substr(0, unit.size() - 1) << std::endl;
+        else
+            std::cout << units / (totalMs / 1000.0) << " " << unit << "/sec" << std::endl;
+    }
+
+    // Generated terrain with every section filled in, the usual mix of sky, surface and stone
+    std::shared_ptr<Chunk> makeTerrainChunk(const TerrainGenerator &generator, ChunkCoord coord)
+    {
+        auto chunk = std::make_shared<Chunk>(nullptr, coord);
+        chunk->generateTerrain(generator);
+        for (int i = 0; i < SECTIONS_PER_CHUNK; i++)
+            chunk->materializeSection(i, generator);
+        return chunk;
+    }
+
+    // How chunks stored blocks before palette sections: one entry per block in a flat vector,
+    // x changing fastest, then y, then z
+    class FlatChunk
+    {
+    public:
+        struct Block
+        {
+            BlockType type;
+            glm::ivec3 position;
+            uint8_t skylight;
+        };
+
+        explicit FlatChunk(const Chunk &chunk) : blocks_(CHUNK_VOLUME)
+        {
+            for (int z = 0; z < CHUNK_SIZE_Z; z++)
+                for (int y = 0; y < CHUNK_SIZE_Y; y++)
+                    for (int x = 0; x < CHUNK_SIZE_X; x++)
+                        blocks_[getIndex({x, y, z})] = {chunk.getBlockType({x, y, z}), {x, y, z}, 0};
+        }
+
+        inline BlockType getBlockType(const glm::ivec3 &pos) const { return blocks_[getIndex(pos)].type; }
+        inline void setBlockAt(const glm::ivec3 &pos, BlockType type) { blocks_[getIndex(pos)] = {type, pos, 0}; }
+
+    private:
+        std::vector<Block> blocks_;
+
+        static inline size_t getIndex(const glm::ivec3 &pos) { return pos.x + pos.y * CHUNK_SIZE_X + pos.z * CHUNK_SIZE_X * CHUNK_SIZE_Y; }
+    };
+
+    // Every block once, in the order a loop over the world usually goes: y, then z, then x fastest
+    template <typename ChunkType>
+    size_t readAll(const ChunkType &chunk)
+    {
+        size_t sum = 0;
+        for (int y = 0; y < CHUNK_SIZE_Y; y++)
+            for (int z = 0; z < CHUNK_SIZE_Z; z++)
+                for (int x = 0; x < CHUNK_SIZE_X; x++)
+                    sum += chunk.getBlockType({x, y, z});
+        readSink = readSink + sum;
+        return CHUNK_VOLUME;
+    }
+
+    // Top to bottom down each column, like sky light and the height map do
+    size_t readColumns(const Chunk &chunk)
+    {
+        size_t sum = 0;
+        for (int z = 0; z < CHUNK_SIZE_Z; z++)
+            for (int x = 0; x < CHUNK_SIZE_X; x++)
+                for (int y = CHUNK_SIZE_Y - 1; y >= 0; y--)
+                    sum += chunk.getBlockType({x, y, z});
+        readSink = readSink + sum;
+        return CHUNK_VOLUME;
+    }
+
+    template <typename ChunkType>
+    size_t readPositions(const ChunkType &chunk, const std::vector<glm::ivec3> &positions)
+    {
+        size_t sum = 0;
+        for (const auto &pos : positions)
+            sum += chunk.getBlockType(pos);
+        readSink = readSink + sum;
+        return positions.size();
+    }
+
+    template <typename ChunkType>
+    size_t writePositions(ChunkType &chunk, const std::vector<glm::ivec3> &positions, const std::vector<BlockType> &types)
+    {
+        for (size_t i = 0; i < positions.size(); i++)
+            chunk.setBlockAt(positions[i], types[i]);
+        return positions.size();
+    }
+
+    void runAccess(int iterations)
+    {
+        const TerrainGenerator generator;
+        auto chunk = makeTerrainChunk(generator, {0, 0});
+        FlatChunk flatChunk(*chunk);
+
+        // Random blocks anywhere in the chunk, and random edits near the surface like a player makes
+        std::mt19937 rng(1);
+        std::vector<glm::ivec3> randomPositions(CHUNK_VOLUME);
+        for (auto &pos : randomPositions)
+            pos = {static_cast<int>(rng() % CHUNK_SIZE_X), static_cast<int>(rng() % CHUNK_SIZE_Y), static_cast<int>(rng() % CHUNK_SIZE_Z)};
+
+        const BlockType editTypes[] = {BlockType::Air, BlockType::Stone, BlockType::Dirt, BlockType::Plank, BlockType::Glass};
+        std::vector<glm::ivec3> editPositions(4096);
+        std::vector<BlockType> editBlocks(editPositions.size());
+        for (size_t i = 0; i < editPositions.size(); i++)
+        {
+            const int x = static_cast<int>(rng() % CHUNK_SIZE_X);
+            const int z = static_cast<int>(rng() % CHUNK_SIZE_Z);
+            const int y = std::clamp(chunk->getHeight(x, z) + static_cast<int>(rng() % 9) - 4, 0, CHUNK_SIZE_Y - 1);
+            editPositions[i] = {x, y, z};
+            editBlocks[i] = editTypes[rng() % 5];
+        }
+
+        std::cout << "Palette sections:" << std::endl;
+        runBenchmark("Read every block", "blocks", iterations, [&]()
+                     { return readAll(*chunk); });
+        runBenchmark("Read random blocks", "blocks", iterations, [&]()
+                     { return readPositions(*chunk, randomPositions); });
+        runBenchmark("Edit near the surface", "blocks", iterations, [&]()
+                     { return writePositions(*chunk, editPositions, editBlocks); });
+        std::cout << "  Memory: " << chunk->getMemoryUsage() / 1024 << "KB" << std::endl;
+
+        std::cout << "Flat array:" << std::endl;
+        runBenchmark("Read every block", "blocks", iterations, [&]()
+                     { return readAll(flatChunk); });
+        runBenchmark("Read random blocks", "blocks", iterations, [&]()
+                     { return readPositions(flatChunk, randomPositions); });
+        runBenchmark("Edit near the surface", "blocks", iterations, [&]()
+                     { return writePositions(flatChunk, editPositions, editBlocks); });
+        std::cout << "  Memory: " << CHUNK_VOLUME * sizeof(FlatChunk::Block) / 1024 << "KB" << std::endl;
+    }
+
+    void runLayout(int iterations)
+    {
+        std::cout << "Layout " << ChunkBlockLayout::name << ":" << std::endl;
+
+        // A new spot every run so the noise tile cache doesn't make generation look free
+        const TerrainGenerator generator;
+        Chunk scratchChunk(nullptr, {0, 0});
+        int nextChunkX = 0;
+        runBenchmark("Generate terrain, all sections", "chunks", iterations, [&]()
+                     {
+                         scratchChunk.reset({nextChunkX++, 0});
+                         scratchChunk.generateTerrain(generator);
+                         for (int i = 0; i < SECTIONS_PER_CHUNK; i++)
+                             scratchChunk.materializeSection(i, generator);
+                         return size_t{1}; });
+
+        auto chunk = makeTerrainChunk(generator, {0, 0});
+        LightSystem lightSystem;
+        for (auto engine : {LightSystem::SkylightEngine::Bfs, LightSystem::SkylightEngine::Bitwise})
+        {
+            lightSystem.setSkylightEngine(engine);
+            const bool bfs = engine == LightSystem::SkylightEngine::Bfs;
+            runBenchmark(bfs ? "Initial sky light, BFS" : "Initial sky light, bitwise", "chunks", iterations, [&]()
+                         {
+                             chunk->clearSkylight();
+                             lightSystem.seedInitialSkylight(chunk);
+                             return size_t{1}; });
+        }
+
+        // The neighbors read as unlit air, only the center chunk's blocks are walked
+        const TextureAtlas atlas(256, 256);
+        const std::array<std::shared_ptr<Chunk>, 4> neighbors{};
+        size_t faceCount = 0;
+        runBenchmark("Mesh every section", "chunks", iterations, [&]()
+                     {
+                         MeshData meshData;
+                         ChunkMeshBuilder builder(meshData, atlas, chunk, neighbors);
+                         for (int i = 0; i < SECTIONS_PER_CHUNK; i++)
+                             builder.buildSectionMesh(i);
+                         faceCount = meshData.indices_.size() / 6;
+                         return size_t{1}; });
+        std::cout << "  Faces per mesh: " << faceCount << std::endl;
+
+        runBenchmark("Read layer by layer", "blocks", iterations, [&]()
+                     { return readAll(*chunk); });
+        runBenchmark("Read column by column", "blocks", iterations, [&]()
+                     { return readColumns(*chunk); });
+    }
+
+    // Vertex and index counts of each section's mesh, so loading can fill mesh buffers like
+    // meshing does without paying for the meshing itself
+    std::vector<std::pair<size_t, size_t>> getSectionMeshSizes(std::shared_ptr<Chunk> chunk)
+    {
+        const TextureAtlas atlas(256, 256);
+        const std::array<std::shared_ptr<Chunk>, 4> neighbors{};
+        std::vector<std::pair<size_t, size_t>> sizes;
+        for (int i = 0; i < SECTIONS_PER_CHUNK; i++)
+        {
+            MeshData meshData;
+            ChunkMeshBuilder(meshData, atlas, chunk, neighbors).buildSectionMesh(i);
+            if (!meshData.indices_.empty())
+                sizes.emplace_back(meshData.vertices_.size(), meshData.indices_.size());
+        }
+        return sizes;
+    }
+
+    void fillMeshData(MeshData &meshData, const std::pair<size_t, size_t> &size)
+    {
+        for (size_t i = 0; i < size.first; i++)
+            meshData.vertices_.push_back(Vertex{});
+        for (size_t i = 0; i < size.second; i++)
+            meshData.indices_.push_back(static_cast<unsigned int>(i));
+    }
+
+    void runPool(int iterations)
+    {
+        // Flying in a straight line, every run loads a chunk in front and unloads one behind
+        constexpr size_t LOADED_CHUNKS = 64;
+        const TerrainGenerator generator;
+        const auto meshSizes = getSectionMeshSizes(makeTerrainChunk(generator, {0, 0}));
+
+        for (bool generate : {false, true})
+        {
+            std::cout << (generate ? "Load with terrain:" : "Load only:") << std::endl;
+
+            ChunkPool pool(nullptr, CHUNK_POOL_SIZE, MESH_SCRATCH_POOL_SIZE);
+            std::deque<std::shared_ptr<Chunk>> loadedChunks;
+            int nextChunkX = 0;
+            runBenchmark("ChunkPool", "chunks", iterations, [&]()
+                         {
+                             auto chunk = pool.acquire({nextChunkX++, 0});
+                             if (generate)
+                                 chunk->generateTerrain(generator);
+                             for (const auto &size : meshSizes)
+                             {
+                                 MeshData meshData = pool.acquireMeshData();
+                                 fillMeshData(meshData, size);
+                                 pool.releaseMeshData(std::move(meshData));
+                             }
+
+                             loadedChunks.push_back(std::move(chunk));
+                             if (loadedChunks.size() > LOADED_CHUNKS)
+                             {
+                                 pool.release(std::move(loadedChunks.front()));
+                                 loadedChunks.pop_front();
+                             }
+                             return size_t{1}; });
+            std::cout << "  Retained: " << pool.getRetainedBytes() / 1024 << "KB" << std::endl;
+
+            loadedChunks.clear();
+            nextChunkX = 0;
+            runBenchmark("make_shared", "chunks", iterations, [&]()
+                         {
+                             auto chunk = std::make_shared<Chunk>(nullptr, ChunkCoord{nextChunkX++, 0});
+                             if (generate)
+                                 chunk->generateTerrain(generator);
+                             for (const auto &size : meshSizes)
+                             {
+                                 MeshData meshData;
+                                 fillMeshData(meshData, size);
+                             }
+
+                             loadedChunks.push_back(std::move(chunk));
+                             if (loadedChunks.size() > LOADED_CHUNKS)
+                                 loadedChunks.pop_front();
+                             return size_t{1}; });
+        }
+    }
+
+    // How chunks were generated before the two pass generator: height and cave noise sampled for
+    // every block, sky included, with the flat world constants of the time
+    void generateTerrainPerBlock(Chunk &chunk, const TerrainGenerator &generator)
+    {
+        constexpr int TERRAIN_BASE_HEIGHT = 128;
+        constexpr int TERRAIN_HEIGHT_VARIATION = 96;
+        constexpr int STONE_LEVEL = 100;
+        constexpr float CAVE_THRESHOLD = 0.6f;
+
+        for (int x = 0; x < CHUNK_SIZE_X; x++)
+        {
+            for (int z = 0; z < CHUNK_SIZE_Z; z++)
+            {
+                for (int y = 0; y < CHUNK_SIZE_Y; y++)
+                {
+                    const float worldX = static_cast<float>(chunk.getCoord().x * CHUNK_SIZE_X + x);
+                    const float worldZ = static_cast<float>(chunk.getCoord().z * CHUNK_SIZE_Z + z);
+
+                    const float centeredNoise = generator.getTerrainNoise(worldX, worldZ) - 0.5f;
+                    const int height = TERRAIN_BASE_HEIGHT + static_cast<int>(centeredNoise * TERRAIN_HEIGHT_VARIATION * 2.0f);
+
+                    BlockType type = BlockType::Stone;
+                    if (y > height)
+                        type = BlockType::Air;
+                    else if (y == height)
+                        type = BlockType::Grass;
+                    else if (y > STONE_LEVEL)
+                        type = BlockType::Dirt;
+
+                    const float caveVal = generator.getCaveNoise(worldX, static_cast<float>(y), worldZ);
+                    if (y <= height && caveVal > CAVE_THRESHOLD && y > 0)
+                        type = BlockType::Air;
+
+                    if (type != BlockType::Air)
+                        chunk.setBlockAt({x, y, z}, type);
+                }
+            }
+        }
+    }
+
+    void runTerrain(int iterations)
+    {
+        // A new spot every run so the noise tile cache doesn't make generation look free
+        const TerrainGenerator generator;
+        Chunk chunk(nullptr, {0, 0});
+        int nextChunkX = 0;
+
+        runBenchmark("Noise for every block", "chunks", iterations, [&]()
+                     {
+                         chunk.reset({nextChunkX++, 0});
+                         generateTerrainPerBlock(chunk, generator);
+                         return size_t{1}; });
+        runBenchmark("generateTerrain", "chunks", iterations, [&]()
+                     {
+                         chunk.reset({nextChunkX++, 0});
+                         chunk.generateTerrain(generator);
+                         return size_t{1}; });
+        runBenchmark("generateTerrain, all sections", "chunks", iterations, [&]()
+                     {
+                         chunk.reset({nextChunkX++, 0});
+                         chunk.generateTerrain(generator);
+                         for (int i = 0; i < SECTIONS_PER_CHUNK; i++)
+                             chunk.materializeSection(i, generator);
+                         return size_t{1}; });
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 100;
+    const bool validArgs = argc == 2 || (argc == 4 && std::string(argv[2]) == "--iterations");
+    if (validArgs && argc == 4)
+        iterations = std::max(std::atoi(argv[3]), 1);
+
+    const std::string mode = argc >= 2 ? argv[1] : "";
+    if (validArgs && mode == "access")
+    {
+        runAccess(iterations);
+        return 0;
+    }
+    if (validArgs && mode == "layout")
+    {
+        runLayout(iterations);
+        return 0;
+    }
+    if (validArgs && mode == "pool")
+    {
+        runPool(iterations);
+        return 0;
+    }
+    if (validArgs && mode == "terrain")
+    {
+        runTerrain(iterations);
+        return 0;
+    }
+
+    std::cerr << "Usage: chunk_bench <access|layout|pool|terrain> [--iterations N]" << std::endl;
+    return 1;
+}
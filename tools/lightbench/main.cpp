@@ -0,0 +1,136 @@
+// Light propagation microbenchmark: lights a worst case chunk, one big open cave with a stone floor
+// and roof, over and over and reports how many BFS nodes per second LightSystem gets through.
+// Initial sky light is run with both engines, on the cave and on a generated terrain chunk,
+// and the two engines' light is checked to be the same.
+//
+// Usage: light_bench [--iterations N]
+
+#include "Chunk/Chunk.h"
+#include "LightSystem.h"
+#include "TerrainGenerator.h"
+#include "Constants.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Open air from y = 1 to the roof at the top of the chunk. Every fourth column of the roof is
+    // open to the sky when skyHoles is set, otherwise light can only come in from the sides
+    std::shared_ptr<Chunk> makeCaveChunk(ChunkCoord coord, bool skyHoles)
+    {
+        using namespace Constants;
+
+        auto chunk = std::make_shared<Chunk>(nullptr, coord);
+        for (int z = 0; z < CHUNK_SIZE_Z; z++)
+        {
+            for (int x = 0; x < CHUNK_SIZE_X; x++)
+            {
+                chunk->setBlockAt({x, 0, z}, BlockType::Stone);
+                if (!skyHoles || x % 4 != 2 || z % 4 != 2)
+                    chunk->setBlockAt({x, CHUNK_SIZE_Y - 1, z}, BlockType::Stone);
+            }
+        }
+        return chunk;
+    }
+
+    // Runs the light pass the given number of times, the chunk's light is cleared before each one.
+    // unit names what the pass's return value counts
+    void runBenchmark(const std::string &name, const std::string &unit, int iterations, Chunk &chunk,
+                      const std::function<size_t()> &lightPass)
+    {
+        size_t nodes = 0;
+        double totalMs = 0.0;
+        for (int i = 0; i < iterations; i++)
+        {
+            chunk.clearSkylight();
+
+            const auto start = std::chrono::steady_clock::now();
+            nodes += lightPass();
+            totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        std::cout << name << ": " << nodes / iterations << " " << unit << ", " << totalMs / iterations << "ms per chunk, "
+                  << nodes / (totalMs / 1000.0) / 1e6 << "M " << unit << "/sec" << std::endl;
+    }
+
+    std::vector<uint8_t> getSkylight(const Chunk &chunk)
+    {
+        using namespace Constants;
+
+        std::vector<uint8_t> light;
+        light.reserve(CHUNK_SIZE_X * CHUNK_SIZE_Y * CHUNK_SIZE_Z);
+        for (int y = 0; y < CHUNK_SIZE_Y; y++)
+            for (int z = 0; z < CHUNK_SIZE_Z; z++)
+                for (int x = 0; x < CHUNK_SIZE_X; x++)
+                    light.push_back(chunk.getSkylight({x, y, z}));
+        return light;
+    }
+
+    // Benchmarks initial sky light with both engines, returns false if they lit the chunk differently
+    bool compareSkylightEngines(const std::string &name, int iterations, LightSystem &lightSystem,
+                                const std::shared_ptr<Chunk> &chunk)
+    {
+        lightSystem.setSkylightEngine(LightSystem::SkylightEngine::Bfs);
+        runBenchmark(name + ", BFS", "nodes", iterations, *chunk, [&]()
+                     { return lightSystem.seedInitialSkylight(chunk); });
+        const std::vector<uint8_t> bfsLight = getSkylight(*chunk);
+
+        lightSystem.setSkylightEngine(LightSystem::SkylightEngine::Bitwise);
+        runBenchmark(name + ", bitwise", "blocks", iterations, *chunk, [&]()
+                     { return lightSystem.seedInitialSkylight(chunk); });
+        const std::vector<uint8_t> bitwiseLight = getSkylight(*chunk);
+
+        if (bfsLight == bitwiseLight)
+            return true;
+
+        std::cerr << name << ": the engines' light differs" << std::endl;
+        return false;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 200;
+    if (argc == 3 && std::string(argv[1]) == "--iterations")
+        iterations = std::max(std::atoi(argv[2]), 1);
+    else if (argc != 1)
+    {
+        std::cerr << "Usage: light_bench [--iterations N]" << std::endl;
+        return 1;
+    }
+
+    LightSystem lightSystem;
+
+    // Sky light falls through the holes and floods the cave from above
+    bool enginesAgree = compareSkylightEngines("Initial skylight", iterations, lightSystem, makeCaveChunk({0, 0}, true));
+
+    // Hills, trees and caves, what the pipeline lights most of the time
+    const TerrainGenerator terrainGenerator;
+    auto terrainChunk = std::make_shared<Chunk>(nullptr, ChunkCoord{0, 0});
+    terrainChunk->generateTerrain(terrainGenerator);
+    enginesAgree &= compareSkylightEngines("Terrain skylight", iterations, lightSystem, terrainChunk);
+
+    // Closed cave between four fully lit chunks, every border block gets seeded
+    auto borderCave = makeCaveChunk({0, 0}, false);
+    LightSystem::Neighborhood neighborhood;
+    neighborhood[4] = borderCave;
+    // North, south, east, west of the middle
+    for (const int i : {7, 1, 5, 3})
+    {
+        neighborhood[i] = std::make_shared<Chunk>(nullptr, ChunkCoord{i % 3 - 1, i / 3 - 1});
+        lightSystem.seedInitialSkylight(neighborhood[i]);
+    }
+    runBenchmark("Border light", "nodes", iterations, *borderCave, [&]()
+                 { return lightSystem.updateBorderLighting(neighborhood).nodes; });
+
+    return enginesAgree ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include "RegionWriter.h"
+#include "Chunk/Chunk.h"
+#include "Constants.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace
+{
+    void writeU32(std::vector<uint8_t> &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+
+    bool isLightUniform(const ChunkSection &section, LightChannel channel)
+    {
+        const uint8_t first = section.getLight(channel, 0);
+        for (int i = 1; i < ChunkSection::VOLUME; i++)
+        {
+            if (section.getLight(channel, i) != first)
+                return false;
+        }
+        return true;
+    }
+
+    void writeLight(std::vector<uint8_t> &out, const ChunkSection &section, LightChannel channel, bool uniform)
+    {
+        constexpr int SIZE = ChunkSection::SIZE;
+
+        if (uniform)
+        {
+            out.push_back(section.getLight(channel, 0));
+            return;
+        }
+
+        for (int y = 0; y < SIZE; y++)
+        {
+            for (int z = 0; z < SIZE; z++)
+            {
+                for (int x = 0; x < SIZE; x += 2)
+                {
+                    const uint8_t low = section.getLight(channel, ChunkSection::getBlockIndex({x, y, z}));
+                    const uint8_t high = section.getLight(channel, ChunkSection::getBlockIndex({x + 1, y, z}));
+                    out.push_back(static_cast<uint8_t>(low | (high << 4)));
+                }
+            }
+        }
+    }
+
+    void writeSection(std::vector<uint8_t> &out, const ChunkSection &section, bool generated)
+    {
+        constexpr int SIZE = ChunkSection::SIZE;
+
+        // Blocks and light go out in a fixed order so files don't depend on CHUNK_BLOCK_LAYOUT
+        const bool uniformSkylight = isLightUniform(section, LightChannel::Sky);
+        const bool uniformBlocklight = isLightUniform(section, LightChannel::Block);
+
+        out.push_back(static_cast<uint8_t>((section.isUniform() ? 1 : 0) | (uniformSkylight ? 2 : 0) |
+                                           (generated ? 0 : 4) | (uniformBlocklight ? 8 : 0)));
+
+        if (section.isUniform())
+        {
+            out.push_back(static_cast<uint8_t>(section.getUniformBlock()));
+        }
+        else
+        {
+            for (int y = 0; y < SIZE; y++)
+                for (int z = 0; z < SIZE; z++)
+                    for (int x = 0; x < SIZE; x++)
+                        out.push_back(static_cast<uint8_t>(section.getBlock(ChunkSection::getBlockIndex({x, y, z}))));
+        }
+
+        writeLight(out, section, LightChannel::Sky, uniformSkylight);
+        writeLight(out, section, LightChannel::Block, uniformBlocklight);
+    }
+}
+
+size_t RegionWriter::writeRegion(const std::filesystem::path &directory, int regionX, int regionZ,
+                                 const std::vector<std::shared_ptr<Chunk>> &chunks)
+{
+    static_assert(BlockTypeCount <= 256, "Region files store blocks as single bytes");
+
+    std::vector<uint8_t> data = {'M', 'C', 'R', 'G'};
+    writeU32(data, VERSION);
+    writeU32(data, static_cast<uint32_t>(chunks.size()));
+
+    for (const auto &chunk : chunks)
+    {
+        writeU32(data, static_cast<uint32_t>(chunk->getCoord().x));
+        writeU32(data, static_cast<uint32_t>(chunk->getCoord().z));
+        for (int i = 0; i < Constants::SECTIONS_PER_CHUNK; i++)
+            writeSection(data, chunk->getSection(i), chunk->isSectionGenerated(i));
+    }
+
+    const auto path = directory / ("r." + std::to_string(regionX) + "." + std::to_string(regionZ) + ".bin");
+    std::ofstream file(path, std::ios::binary);
+    if (!file.write(reinterpret_cast<const char *>(data.data()), data.size()))
+        return 0;
+    return data.size();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+class Chunk;
+
+// Saves chunks into region files of REGION_SIZE x REGION_SIZE chunks, named r.<x>.<z>.bin.
+// Little endian layout: "MCRG", u32 version, u32 chunk count, then per chunk its i32 x and z
+// followed by its sections bottom to top. A section is a flags byte (1 = uniform blocks,
+// 2 = uniform skylight, 4 = placeholder stone that hasn't been generated yet, 8 = uniform
+// block light), then one block byte or 4096 of them in y, z, x order, then for sky light and
+// then block light one byte or 2048 bytes of nibbles in the same order, low nibble first
+namespace RegionWriter
+{
+    constexpr int REGION_SIZE = 32;
+    constexpr uint32_t VERSION = 2;
+
+    // Region holding a chunk coordinate, rounds towards negative infinity
+    inline int getRegion(int chunkCoord) { return chunkCoord >= 0 ? chunkCoord / REGION_SIZE : (chunkCoord + 1) / REGION_SIZE - 1; }
+
+    // Returns the number of bytes written, 0 if the file couldn't be written
+    size_t writeRegion(const std::filesystem::path &directory, int regionX, int regionZ,
+                       const std::vector<std::shared_ptr<Chunk>> &chunks);
+}
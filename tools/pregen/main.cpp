@@ -0,0 +1,261 @@
+// Headless world pregeneration: generates terrain, features and lighting for every chunk within a
+// radius of the origin on all cores, then saves them as region files. No window or GL context needed.
+//
+// Usage: world_pregen [--seed N] [--radius CHUNKS] [--threads N] [--out DIR]
+
+#include "RegionWriter.h"
+#include "Chunk/Chunk.h"
+#include "Chunk/PendingBlockWrites.h"
+#include "FeatureGenerator.h"
+#include "LightSystem.h"
+#include "TerrainGenerator.h"
+#include "ThreadPool.h"
+#include "Constants.h"
+#include "Performance/Profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    struct Options
+    {
+        int seed = Constants::WORLD_SEED;
+        int radius = Constants::RENDER_DISTANCE;
+        size_t threads = std::thread::hardware_concurrency();
+        std::filesystem::path outDirectory = "pregen";
+    };
+
+    using ChunkMap = std::unordered_map<ChunkCoord, std::shared_ptr<Chunk>>;
+
+    bool parseOptions(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc)
+                return false;
+
+            const char *value = argv[++i];
+            if (arg == "--seed")
+                options.seed = std::atoi(value);
+            else if (arg == "--radius")
+                options.radius = std::atoi(value);
+            else if (arg == "--threads")
+                options.threads = static_cast<size_t>(std::atoi(value));
+            else if (arg == "--out")
+                options.outDirectory = value;
+            else
+                return false;
+        }
+
+        options.threads = std::max<size_t>(options.threads, 1);
+        return options.radius >= 0;
+    }
+
+    size_t getPeakMemoryBytes()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return counters.PeakWorkingSetSize;
+        return 0;
+#else
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    // Runs the work for every chunk on the pool and waits for all of it, returns the wall time in ms
+    double runStage(ThreadPool &pool, const std::vector<std::shared_ptr<Chunk>> &chunks,
+                    const std::function<void(const std::shared_ptr<Chunk> &)> &work)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::future<void>> tasks;
+        tasks.reserve(chunks.size());
+        for (const auto &chunk : chunks)
+            tasks.push_back(pool.enqueue([&work, chunk]() { work(chunk); }));
+        for (auto &task : tasks)
+            task.get();
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    LightSystem::Neighborhood getNeighborhood(const ChunkMap &chunks, const ChunkCoord &coord)
+    {
+        LightSystem::Neighborhood neighborhood;
+        for (int dz = -1; dz <= 1; dz++)
+        {
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                auto it = chunks.find({coord.x + dx, coord.z + dz});
+                if (it != chunks.end())
+                    neighborhood[(dz + 1) * 3 + dx + 1] = it->second;
+            }
+        }
+        return neighborhood;
+    }
+
+    // Coordinate mod 3, also for negative coordinates
+    int getPhase(int chunkCoord) { return ((chunkCoord % 3) + 3) % 3; }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: world_pregen [--seed N] [--radius CHUNKS] [--threads N] [--out DIR]" << std::endl;
+        return 1;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(options.outDirectory, error);
+    if (error)
+    {
+        std::cerr << "Can't create " << options.outDirectory << ": " << error.message() << std::endl;
+        return 1;
+    }
+
+    const TerrainGenerator terrainGenerator(options.seed);
+    const FeatureGenerator featureGenerator(terrainGenerator, options.seed);
+    PendingBlockWrites pendingWrites;
+    LightSystem lightSystem;
+    ThreadPool pool(options.threads);
+
+    // Same cylinder the client loads around the player
+    ChunkMap chunkMap;
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    const int R = options.radius;
+    for (int dx = -R; dx <= R; dx++)
+    {
+        for (int dz = -R; dz <= R; dz++)
+        {
+            if (dx * dx + dz * dz > R * R)
+                continue;
+
+            auto chunk = std::make_shared<Chunk>(nullptr, ChunkCoord{dx, dz});
+            chunkMap.emplace(chunk->getCoord(), chunk);
+            chunks.push_back(std::move(chunk));
+        }
+    }
+
+    std::cout << "Generating " << chunks.size() << " chunks, seed " << options.seed << ", radius " << R
+              << ", " << options.threads << " threads" << std::endl;
+
+    // Every chunk's features are placed before any chunk takes the blocks its neighbors spilled into it,
+    // so unlike in the client nothing arrives late
+    const double terrainMs = runStage(pool, chunks, [&](const std::shared_ptr<Chunk> &chunk)
+                                      {
+                                          chunk->generateTerrain(terrainGenerator);
+                                          featureGenerator.placeFeatures(*chunk, pendingWrites);
+                                      });
+
+    const double initialLightMs = runStage(pool, chunks, [&](const std::shared_ptr<Chunk> &chunk)
+                                           {
+                                               pendingWrites.applyTo(*chunk);
+                                               lightSystem.seedInitialSkylight(chunk);
+                                               // Same as ChunkPipeline, caves lit from the surface get the sections below them generated
+                                               for (int i = chunk->findLitPlaceholderSection(); i >= 0; i = chunk->findLitPlaceholderSection())
+                                               {
+                                                   chunk->materializeSection(i, terrainGenerator);
+                                                   chunk->clearSkylight();
+                                                   lightSystem.seedInitialSkylight(chunk);
+                                               }
+                                               lightSystem.seedInitialBlocklight(chunk);
+                                           });
+
+    // Border light reads and writes the 3x3 chunks around a chunk. Chunks with the same x and z mod 3
+    // are at least 3 apart so their windows never overlap, each of the 9 phases runs in parallel
+    std::array<std::vector<std::shared_ptr<Chunk>>, 9> phases;
+    for (const auto &chunk : chunks)
+        phases[getPhase(chunk->getCoord().z) * 3 + getPhase(chunk->getCoord().x)].push_back(chunk);
+
+    double borderLightMs = 0.0;
+    for (const auto &phase : phases)
+    {
+        borderLightMs += runStage(pool, phase, [&](const std::shared_ptr<Chunk> &chunk)
+                                  { lightSystem.updateBorderLighting(getNeighborhood(chunkMap, chunk->getCoord())); });
+    }
+
+    // One task per region file
+    std::map<std::pair<int, int>, std::vector<std::shared_ptr<Chunk>>> regions;
+    for (const auto &chunk : chunks)
+    {
+        const ChunkCoord coord = chunk->getCoord();
+        regions[{RegionWriter::getRegion(coord.x), RegionWriter::getRegion(coord.z)}].push_back(chunk);
+    }
+
+    const auto writeStart = std::chrono::steady_clock::now();
+    std::vector<std::future<size_t>> writes;
+    for (const auto &region : regions)
+    {
+        writes.push_back(pool.enqueue([&options, &region]()
+                                      { return RegionWriter::writeRegion(options.outDirectory, region.first.first, region.first.second, region.second); }));
+    }
+
+    size_t bytesWritten = 0;
+    bool writeFailed = false;
+    for (auto &write : writes)
+    {
+        const size_t bytes = write.get();
+        writeFailed |= bytes == 0;
+        bytesWritten += bytes;
+    }
+    const double writeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - writeStart).count();
+
+    size_t chunkMemory = 0;
+    for (const auto &chunk : chunks)
+        chunkMemory += chunk->getMemoryUsage();
+
+    const double generateMs = terrainMs + initialLightMs + borderLightMs;
+    std::cout << "\nStage wall times" << std::endl;
+    std::cout << "  Terrain + features: " << terrainMs << "ms" << std::endl;
+    std::cout << "  Initial light:      " << initialLightMs << "ms" << std::endl;
+    std::cout << "  Border light:       " << borderLightMs << "ms" << std::endl;
+    std::cout << "  Write:              " << writeMs << "ms, " << regions.size() << " regions, "
+              << bytesWritten / 1024 << "KB" << std::endl;
+    std::cout << "\nChunks/sec: " << chunks.size() * 1000.0 / generateMs << " generated, "
+              << chunks.size() * 1000.0 / (generateMs + writeMs) << " including the write" << std::endl;
+    std::cout << "Chunk memory: " << chunkMemory / (1024 * 1024) << "MB, peak RSS: "
+              << getPeakMemoryBytes() / (1024 * 1024) << "MB" << std::endl;
+
+    // Per call averages of the timers inside the stages
+    std::cout << "\nPer chunk averages" << std::endl;
+    terrainGenerator.reportStats();
+    Profiler::get().renderStats();
+
+    if (writeFailed)
+    {
+        std::cerr << "Some region files couldn't be written to " << options.outDirectory << std::endl;
+        return 1;
+    }
+    return 0;
+}